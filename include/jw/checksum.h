@@ -0,0 +1,462 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <bit>
+#include <array>
+#include <ranges>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <jw/common.h>
+#include <jw/math.h>
+#include <jw/detail/simd.h>
+#if defined(__i386__) or defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Streaming checksums and hashes.  Each state object consumes any number of
+// segments via update(), and the result is obtained with value().  Data
+// may be split anywhere, the result is the same as for one contiguous
+// block.  For one-shot use, see checksum<State>(segments...).
+
+namespace jw
+{
+    template<typename Storage>
+    struct circular_queue;
+}
+
+namespace jw::detail
+{
+    // Implements update() for all byte-oriented states.  Derived classes
+    // provide consume(const byte*, std::size_t).
+    template<typename D>
+    struct checksum_base
+    {
+        D& update(const void* data, std::size_t size) noexcept
+        {
+            if (size > 0) self()->consume(static_cast<const byte*>(data), size);
+            return *self();
+        }
+
+        // Consume the object representation of a contiguous range.
+        template<std::ranges::contiguous_range R> requires (std::is_trivially_copyable_v<std::ranges::range_value_t<R>>)
+        D& update(const R& range) noexcept
+        {
+            return update(std::ranges::data(range), std::ranges::size(range) * sizeof(std::ranges::range_value_t<R>));
+        }
+
+        // Consume the contents of a circular_queue, which is stored in at
+        // most two contiguous segments.
+        template<typename S>
+        D& update(const circular_queue<S>& queue) noexcept
+        {
+            return update(*queue.consumer());
+        }
+
+        // Consume the contents of a circular_queue consumer or producer
+        // interface.
+        template<typename Q> requires (std::is_trivially_copyable_v<typename Q::value_type>
+                                       and requires (const Q& q) { q.contiguous_end(q.begin()); })
+        D& update(const Q& queue) noexcept
+        {
+            auto i = queue.begin();
+            for (auto n = queue.size(); n > 0; )
+            {
+                const auto* p = &*i;
+                const auto k = std::min<std::size_t>(queue.contiguous_end(i) - p, n);
+                update(p, k * sizeof(*p));
+                i += k;
+                n -= k;
+            }
+            return *self();
+        }
+
+    private:
+        D* self() noexcept { return static_cast<D*>(this); }
+    };
+
+#   if defined(__i386__) or defined(__x86_64__)
+    inline bool detect_cpu_feature(bool (*test)()) noexcept
+    {
+        __builtin_cpu_init();
+        return test();
+    }
+
+    inline const bool has_sse42 = detect_cpu_feature([] { return __builtin_cpu_supports("sse4.2") != 0; });
+    inline const bool has_pclmul = detect_cpu_feature([] { return __builtin_cpu_supports("pclmul") and __builtin_cpu_supports("sse4.1"); });
+#   endif
+
+    // Reflected CRC-32 lookup tables for slicing-by-8.  Table k gives the
+    // CRC of a byte followed by k zero bytes.
+    template<std::uint32_t Poly>
+    inline constexpr auto crc32_tables = []() consteval
+    {
+        std::array<std::array<std::uint32_t, 256>, 8> t { };
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for (unsigned k = 0; k < 8; ++k) c = (c >> 1) ^ (c & 1 ? Poly : 0);
+            t[0][i] = c;
+        }
+        for (unsigned k = 1; k < 8; ++k)
+            for (unsigned i = 0; i < 256; ++i)
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+        return t;
+    }();
+
+    template<std::uint32_t Poly>
+    inline std::uint32_t crc32_sliced(std::uint32_t crc, const byte* p, std::size_t n) noexcept
+    {
+        constexpr auto& t = crc32_tables<Poly>;
+        for (; n >= 8; p += 8, n -= 8)
+        {
+            const std::uint32_t lo = load_le<std::uint32_t>(p) ^ crc;
+            const std::uint32_t hi = load_le<std::uint32_t>(p + 4);
+            crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24]
+                ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        }
+        for (; n > 0; ++p, --n)
+            crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+        return crc;
+    }
+
+#   if defined(__i386__) or defined(__x86_64__)
+    [[gnu::target("sse4.2")]]
+    inline std::uint32_t crc32c_sse42(std::uint32_t crc, const byte* p, std::size_t n) noexcept
+    {
+#       ifdef __x86_64__
+        std::uint64_t c = crc;
+        for (; n >= 8; p += 8, n -= 8)
+            c = __builtin_ia32_crc32di(c, load_le<std::uint64_t>(p));
+        crc = static_cast<std::uint32_t>(c);
+#       endif
+        for (; n >= 4; p += 4, n -= 4)
+            crc = __builtin_ia32_crc32si(crc, load_le<std::uint32_t>(p));
+        for (; n > 0; ++p, --n)
+            crc = __builtin_ia32_crc32qi(crc, *p);
+        return crc;
+    }
+
+    [[gnu::target("pclmul,sse4.1"), gnu::always_inline]]
+    inline __m128i clmul_load(const byte* p) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    // Multiply both halves of x by the constants in k, and add next.
+    [[gnu::target("pclmul,sse4.1"), gnu::always_inline]]
+    inline __m128i clmul_fold(__m128i x, __m128i k, __m128i next) noexcept
+    {
+        const __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+        const __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+        return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+    }
+
+    // CRC-32 by folding with carry-less multiplication.  Folds four 128-bit
+    // lanes in parallel, then reduces to 32 bits with Barrett reduction.
+    // Requires n >= 64, and processes a multiple of 16 bytes.  Returns the
+    // number of bytes consumed.  Based on: V. Gopal et al., "Fast CRC
+    // Computation for Generic Polynomials Using PCLMULQDQ Instruction",
+    // Intel, 2009.
+    [[gnu::target("pclmul,sse4.1")]]
+    inline std::size_t crc32_pclmul(std::uint32_t& crc, const byte* p, std::size_t n) noexcept
+    {
+        const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+        const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+        const __m128i k5 = _mm_set_epi64x(0, 0x0163cd6124);
+        const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+        const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+        const std::size_t total = n & ~std::size_t { 15 };
+
+        __m128i x1 = _mm_xor_si128(clmul_load(p), _mm_cvtsi32_si128(crc));
+        __m128i x2 = clmul_load(p + 16);
+        __m128i x3 = clmul_load(p + 32);
+        __m128i x4 = clmul_load(p + 48);
+        p += 64;
+        n = total - 64;
+        for (; n >= 64; p += 64, n -= 64)
+        {
+            x1 = clmul_fold(x1, k1k2, clmul_load(p));
+            x2 = clmul_fold(x2, k1k2, clmul_load(p + 16));
+            x3 = clmul_fold(x3, k1k2, clmul_load(p + 32));
+            x4 = clmul_fold(x4, k1k2, clmul_load(p + 48));
+        }
+
+        x1 = clmul_fold(x1, k3k4, x2);
+        x1 = clmul_fold(x1, k3k4, x3);
+        x1 = clmul_fold(x1, k3k4, x4);
+        for (; n >= 16; p += 16, n -= 16)
+            x1 = clmul_fold(x1, k3k4, clmul_load(p));
+
+        // Fold 128 to 64 bits, then to 32.
+        __m128i x = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k3k4, 0x10));
+        x = _mm_xor_si128(_mm_srli_si128(x, 4), _mm_clmulepi64_si128(_mm_and_si128(x, mask32), k5, 0x00));
+
+        __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x, mask32), poly, 0x10);
+        t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), poly, 0x00);
+        crc = _mm_extract_epi32(_mm_xor_si128(x, t), 1);
+        return total;
+    }
+#   endif
+
+    inline constexpr std::uint32_t crc32_poly = 0xedb88320;     // IEEE 802.3
+    inline constexpr std::uint32_t crc32c_poly = 0x82f63b78;    // Castagnoli
+}
+
+namespace jw
+{
+    // Sum of all bytes, modulo 256.  Same as checksum8().
+    struct sum8_checksum : detail::checksum_base<sum8_checksum>
+    {
+        using value_type = std::uint8_t;
+
+        value_type value() const noexcept { return sum; }
+
+    private:
+        friend struct detail::checksum_base<sum8_checksum>;
+        void consume(const byte* p, std::size_t n) noexcept { sum += detail::sum_bytes(p, n); }
+
+        std::uint8_t sum { 0 };
+    };
+
+    // Internet checksum, as used in IP, UDP and TCP headers (RFC 1071).
+    // This is the ones' complement of the ones' complement sum of all
+    // 16-bit big-endian words.  The result should be stored in big-endian
+    // order.  When computed over data that includes a valid checksum, the
+    // result is zero.
+    struct internet_checksum : detail::checksum_base<internet_checksum>
+    {
+        using value_type = std::uint16_t;
+
+        value_type value() const noexcept
+        {
+            std::uint64_t s = sum;
+            while (s >> 16) s = (s & 0xffff) + (s >> 16);
+            return static_cast<std::uint16_t>(~s);
+        }
+
+    private:
+        friend struct detail::checksum_base<internet_checksum>;
+        void consume(const byte* p, std::size_t n) noexcept
+        {
+            if (odd)
+            {
+                sum += *p++;
+                --n;
+            }
+            odd = n & 1;
+            if (odd) sum += std::uint32_t { p[n - 1] } << 8;
+            n /= 2;
+
+            // Partial sums of up to 2^16 words fit in 32 bits.
+            detail::simd_dispatch([p, n, &s = sum]
+            {
+                std::uint64_t total = 0;
+                for (std::size_t i = 0; i < n; )
+                {
+                    const std::size_t m = std::min<std::size_t>(n - i, 0x10000);
+                    std::uint32_t s32 = 0;
+                    for (std::size_t j = 0; j < m; ++j)
+                        s32 += (p[2 * (i + j)] << 8) | p[2 * (i + j) + 1];
+                    total += s32;
+                    i += m;
+                }
+                s += total;
+            });
+        }
+
+        std::uint64_t sum { 0 };
+        bool odd { false };
+    };
+
+    // Adler-32, as used in zlib (RFC 1950).
+    struct adler32_checksum : detail::checksum_base<adler32_checksum>
+    {
+        using value_type = std::uint32_t;
+
+        value_type value() const noexcept { return (b << 16) | a; }
+
+    private:
+        friend struct detail::checksum_base<adler32_checksum>;
+
+        // Over a block of n bytes, a increases by the sum of all bytes, and
+        // b by n * a plus the sum of each byte times its distance to the
+        // end of the block.  Both sums are independent for each byte, so
+        // they vectorize.  Blocks are limited to 5552 bytes, the largest
+        // size for which the weighted sum fits in 32 bits.
+        void consume(const byte* p, std::size_t n) noexcept
+        {
+            detail::simd_dispatch([p, n, &a = a, &b = b]
+            {
+                constexpr std::uint32_t base = 65521;
+                std::uint32_t x = a, y = b;
+                for (std::size_t i = 0; i < n; )
+                {
+                    const std::uint32_t m = std::min<std::size_t>(n - i, 5552);
+                    std::uint32_t s1 = 0, s2 = 0;
+                    for (std::uint32_t j = 0; j < m; ++j)
+                    {
+                        s1 += p[i + j];
+                        s2 += (m - j) * p[i + j];
+                    }
+                    y = (y + std::uint64_t { m } * x + s2) % base;
+                    x = (x + s1) % base;
+                    i += m;
+                }
+                a = x;
+                b = y;
+            });
+        }
+
+        std::uint32_t a { 1 };
+        std::uint32_t b { 0 };
+    };
+
+    // CRC-32 (IEEE 802.3), as used in Ethernet, zlib and PNG.  Uses the
+    // PCLMULQDQ instruction if available, or slicing-by-8 tables.
+    struct crc32_checksum : detail::checksum_base<crc32_checksum>
+    {
+        using value_type = std::uint32_t;
+
+        value_type value() const noexcept { return ~crc; }
+
+    private:
+        friend struct detail::checksum_base<crc32_checksum>;
+        void consume(const byte* p, std::size_t n) noexcept
+        {
+#           if defined(__i386__) or defined(__x86_64__)
+            if (n >= 64 and detail::has_pclmul)
+            {
+                const auto k = detail::crc32_pclmul(crc, p, n);
+                p += k;
+                n -= k;
+            }
+#           endif
+            crc = detail::crc32_sliced<detail::crc32_poly>(crc, p, n);
+        }
+
+        std::uint32_t crc { ~std::uint32_t { 0 } };
+    };
+
+    // CRC-32C (Castagnoli), as used in iSCSI, SCTP and ext4.  Uses the
+    // SSE4.2 CRC32 instruction if available, or slicing-by-8 tables.
+    struct crc32c_checksum : detail::checksum_base<crc32c_checksum>
+    {
+        using value_type = std::uint32_t;
+
+        value_type value() const noexcept { return ~crc; }
+
+    private:
+        friend struct detail::checksum_base<crc32c_checksum>;
+        void consume(const byte* p, std::size_t n) noexcept
+        {
+#           if defined(__i386__) or defined(__x86_64__)
+            if (detail::has_sse42)
+            {
+                crc = detail::crc32c_sse42(crc, p, n);
+                return;
+            }
+#           endif
+            crc = detail::crc32_sliced<detail::crc32c_poly>(crc, p, n);
+        }
+
+        std::uint32_t crc { ~std::uint32_t { 0 } };
+    };
+
+    // XXH64, a fast non-cryptographic 64-bit hash by Y. Collet.  Produces
+    // the same values as the reference implementation.
+    struct xxh64_hash : detail::checksum_base<xxh64_hash>
+    {
+        using value_type = std::uint64_t;
+
+        constexpr xxh64_hash(std::uint64_t seed = 0) noexcept
+            : v { seed + p1 + p2, seed + p2, seed, seed - p1 }, seed { seed } { }
+
+        value_type value() const noexcept
+        {
+            std::uint64_t h;
+            if (total >= 32)
+            {
+                h = std::rotl(v[0], 1) + std::rotl(v[1], 7) + std::rotl(v[2], 12) + std::rotl(v[3], 18);
+                for (auto x : v) h = (h ^ round(0, x)) * p1 + p4;
+            }
+            else h = seed + p5;
+            h += total;
+
+            const byte* p = buf;
+            std::size_t n = size;
+            for (; n >= 8; p += 8, n -= 8)
+                h = std::rotl(h ^ round(0, load_le<std::uint64_t>(p)), 27) * p1 + p4;
+            if (n >= 4)
+            {
+                h = std::rotl(h ^ (load_le<std::uint32_t>(p) * p1), 23) * p2 + p3;
+                p += 4;
+                n -= 4;
+            }
+            for (; n > 0; ++p, --n)
+                h = std::rotl(h ^ (*p * p5), 11) * p1;
+
+            h = (h ^ (h >> 33)) * p2;
+            h = (h ^ (h >> 29)) * p3;
+            return h ^ (h >> 32);
+        }
+
+    private:
+        friend struct detail::checksum_base<xxh64_hash>;
+
+        static constexpr std::uint64_t p1 = 0x9e3779b185ebca87;
+        static constexpr std::uint64_t p2 = 0xc2b2ae3d27d4eb4f;
+        static constexpr std::uint64_t p3 = 0x165667b19e3779f9;
+        static constexpr std::uint64_t p4 = 0x85ebca77c2b2ae63;
+        static constexpr std::uint64_t p5 = 0x27d4eb2f165667c5;
+
+        static constexpr std::uint64_t round(std::uint64_t acc, std::uint64_t x) noexcept
+        {
+            return std::rotl(acc + x * p2, 31) * p1;
+        }
+
+        void stripe(const byte* p) noexcept
+        {
+            for (unsigned i = 0; i < 4; ++i)
+                v[i] = round(v[i], load_le<std::uint64_t>(p + 8 * i));
+        }
+
+        void consume(const byte* p, std::size_t n) noexcept
+        {
+            total += n;
+            if (size > 0)
+            {
+                const std::size_t k = std::min(n, 32 - size);
+                std::memcpy(buf + size, p, k);
+                size += k;
+                p += k;
+                n -= k;
+                if (size < 32) return;
+                stripe(buf);
+                size = 0;
+            }
+            for (; n >= 32; p += 32, n -= 32)
+                stripe(p);
+            std::memcpy(buf, p, n);
+            size = n;
+        }
+
+        std::uint64_t v[4];
+        std::uint64_t seed;
+        std::uint64_t total { 0 };
+        byte buf[32];
+        std::size_t size { 0 };
+    };
+
+    // Compute a checksum or hash over one or more segments, in order.
+    template<typename State, typename... Segments>
+    inline auto checksum(const Segments&... segments)
+    {
+        State s { };
+        (s.update(segments), ...);
+        return s.value();
+    }
+}
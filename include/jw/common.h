@@ -4,8 +4,10 @@
 
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <algorithm>
 #include <bit>
+#include <concepts>
 
 namespace jw
 {
@@ -32,6 +34,32 @@ namespace jw
     template<typename T> T volatile_load(const T* p) noexcept { return *static_cast<const volatile T*>(p); }
     template<typename T> void volatile_store(T* p, const T& v) noexcept { *static_cast<volatile T*>(p) = v; }
 
+    template<std::unsigned_integral T>
+    constexpr T byteswap(T v) noexcept
+    {
+        if constexpr (sizeof(T) == 2) return __builtin_bswap16(v);
+        else if constexpr (sizeof(T) == 4) return __builtin_bswap32(v);
+        else if constexpr (sizeof(T) == 8) return __builtin_bswap64(v);
+        else return v;
+    }
+
+    // Unaligned little-endian load and store of unsigned integers.
+    template<std::unsigned_integral T>
+    inline T load_le(const void* p) noexcept
+    {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big and sizeof(T) > 1) v = byteswap(v);
+        return v;
+    }
+
+    template<std::unsigned_integral T>
+    inline void store_le(void* p, T v) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::big and sizeof(T) > 1) v = byteswap(v);
+        std::memcpy(p, &v, sizeof(T));
+    }
+
     consteval inline std::size_t alignment_for_bits(std::size_t nbits, std::size_t max) noexcept
     {
         if (nbits / 8 == 0) return 1;
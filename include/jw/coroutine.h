@@ -0,0 +1,337 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <iterator>
+#include <utility>
+#include <memory>
+#include <type_traits>
+#include <cstring>
+#include <jw/alloc.h>
+
+namespace jw
+{
+    template<typename T = void>
+    struct task;
+
+    // Returns the pool from which coroutine frames are allocated, if no
+    // allocator is supplied explicitly.  Each thread has its own pool.  All
+    // frames allocated from it must be destroyed before the thread exits.
+    inline pool_resource* coroutine_pool() noexcept
+    {
+        thread_local pool_resource pool { };
+        return &pool;
+    }
+}
+
+namespace jw::detail
+{
+    // Base class for promise types, which allocates coroutine frames from a
+    // pool_resource.  By default this is the thread-local coroutine_pool().
+    // A different pool may be supplied by passing std::allocator_arg and a
+    // monomorphic_allocator<pool_resource> as the first coroutine arguments
+    // (after the object parameter, for member functions).  A pointer to the
+    // pool is stored at the end of each frame.
+    struct pool_allocated_promise
+    {
+        static void* operator new(std::size_t n)
+        {
+            return allocate(n, coroutine_pool());
+        }
+
+        template<typename T, typename... A>
+        static void* operator new(std::size_t n, std::allocator_arg_t, const monomorphic_allocator<pool_resource, T>& alloc, A&&...)
+        {
+            return allocate(n, alloc.resource());
+        }
+
+        template<typename C, typename T, typename... A>
+        static void* operator new(std::size_t n, C&&, std::allocator_arg_t, const monomorphic_allocator<pool_resource, T>& alloc, A&&...)
+        {
+            return allocate(n, alloc.resource());
+        }
+
+        static void operator delete(void* p, std::size_t n) noexcept
+        {
+            const auto size = padded_size(n);
+            pool_resource* pool;
+            std::memcpy(&pool, static_cast<std::byte*>(p) + size, sizeof(pool));
+            monomorphic_allocator<pool_resource> { pool }.deallocate_bytes(p, size + sizeof(pool));
+        }
+
+    private:
+        static constexpr std::size_t padded_size(std::size_t n) noexcept
+        {
+            constexpr std::size_t a = alignof(pool_resource*);
+            return (n + a - 1) & -a;
+        }
+
+        static void* allocate(std::size_t n, pool_resource* pool)
+        {
+            const auto size = padded_size(n);
+            auto* const p = monomorphic_allocator<pool_resource> { pool }.allocate_bytes(size + sizeof(pool));
+            std::memcpy(static_cast<std::byte*>(p) + size, &pool, sizeof(pool));
+            return p;
+        }
+    };
+
+    // On completion of a task, transfer control directly to the awaiting
+    // coroutine, if any.
+    struct task_final_awaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept { return h.promise().continuation; }
+
+        void await_resume() noexcept { }
+    };
+
+    template<typename T>
+    struct task_promise_base : pool_allocated_promise
+    {
+        std::suspend_always initial_suspend() noexcept { return { }; }
+        task_final_awaiter final_suspend() noexcept { return { }; }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        void rethrow_if_exception()
+        {
+            if (exception) std::rethrow_exception(exception);
+        }
+
+        std::coroutine_handle<> continuation { std::noop_coroutine() };
+        std::exception_ptr exception;
+    };
+
+    template<typename T>
+    struct task_promise : task_promise_base<T>
+    {
+        task<T> get_return_object() noexcept { return task<T> { std::coroutine_handle<task_promise>::from_promise(*this) }; }
+
+        template<typename U>
+        void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+        T result()
+        {
+            this->rethrow_if_exception();
+            return std::move(*value);
+        }
+
+        std::optional<T> value;
+    };
+
+    template<>
+    struct task_promise<void> : task_promise_base<void>
+    {
+        task<void> get_return_object() noexcept;
+
+        void return_void() noexcept { }
+
+        void result() { rethrow_if_exception(); }
+    };
+}
+
+namespace jw
+{
+    // A lazily-started coroutine that produces a single value.  When
+    // awaited, the awaiting coroutine is suspended and execution is
+    // transferred to the task.  On completion, control returns directly
+    // to the awaiting coroutine (symmetric transfer).  A task that is not
+    // awaited can be started and resumed via resume(), eg. from an
+    // executor.  Frames are allocated from a pool_resource, see
+    // detail::pool_allocated_promise.
+    template<typename T>
+    struct [[nodiscard]] task
+    {
+        static_assert(not std::is_reference_v<T>);
+
+        using promise_type = detail::task_promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        constexpr task() noexcept = default;
+        task(task&& other) noexcept : h { std::exchange(other.h, nullptr) } { }
+        task(const task&) = delete;
+
+        task& operator=(task&& other) noexcept
+        {
+            if (&other == this) return *this;
+            destroy();
+            h = std::exchange(other.h, nullptr);
+            return *this;
+        }
+
+        task& operator=(const task&) = delete;
+
+        ~task() { destroy(); }
+
+        bool valid() const noexcept { return h != nullptr; }
+        bool done() const noexcept { return h.done(); }
+
+        // Start or continue execution.  The task must not be awaited.
+        void resume() const { h.resume(); }
+
+        // Obtain the result of a completed task, or rethrow the exception
+        // that escaped from it.
+        T result() { return h.promise().result(); }
+
+        auto operator co_await() noexcept
+        {
+            struct awaiter
+            {
+                handle_type h;
+
+                bool await_ready() noexcept { return h.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) noexcept
+                {
+                    h.promise().continuation = c;
+                    return h;
+                }
+
+                T await_resume() { return h.promise().result(); }
+            };
+            return awaiter { h };
+        }
+
+    private:
+        template<typename> friend struct detail::task_promise;
+
+        explicit task(handle_type handle) noexcept : h { handle } { }
+
+        void destroy() noexcept
+        {
+            if (h != nullptr) h.destroy();
+        }
+
+        handle_type h { nullptr };
+    };
+
+    // A lazily evaluated sequence of values, produced by co_yield.  Frames
+    // are allocated from a pool_resource, see
+    // detail::pool_allocated_promise.
+    template<typename T>
+    struct [[nodiscard]] generator
+    {
+        using value_type = std::remove_cvref_t<T>;
+        using reference = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+        struct promise_type : detail::pool_allocated_promise
+        {
+            generator get_return_object() noexcept { return generator { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+
+            std::suspend_always initial_suspend() noexcept { return { }; }
+            std::suspend_always final_suspend() noexcept { return { }; }
+
+            std::suspend_always yield_value(reference v) noexcept
+            {
+                value = std::addressof(v);
+                return { };
+            }
+
+            void return_void() noexcept { }
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+            template<typename U>
+            std::suspend_never await_transform(U&&) = delete;
+
+            void rethrow_if_exception()
+            {
+                if (exception) std::rethrow_exception(exception);
+            }
+
+            std::add_pointer_t<reference> value;
+            std::exception_ptr exception;
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct iterator
+        {
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = generator::value_type;
+            using reference = generator::reference;
+
+            reference operator*() const noexcept { return static_cast<reference>(*h.promise().value); }
+
+            iterator& operator++()
+            {
+                h.resume();
+                h.promise().rethrow_if_exception();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const noexcept { return h.done(); }
+
+            handle_type h;
+        };
+
+        constexpr generator() noexcept = default;
+        generator(generator&& other) noexcept : h { std::exchange(other.h, nullptr) } { }
+        generator(const generator&) = delete;
+
+        generator& operator=(generator&& other) noexcept
+        {
+            if (&other == this) return *this;
+            destroy();
+            h = std::exchange(other.h, nullptr);
+            return *this;
+        }
+
+        generator& operator=(const generator&) = delete;
+
+        ~generator() { destroy(); }
+
+        // Start the generator and return an iterator to the first value.
+        // May only be called once.
+        iterator begin()
+        {
+            h.resume();
+            h.promise().rethrow_if_exception();
+            return { h };
+        }
+
+        std::default_sentinel_t end() const noexcept { return { }; }
+
+    private:
+        explicit generator(handle_type handle) noexcept : h { handle } { }
+
+        void destroy() noexcept
+        {
+            if (h != nullptr) h.destroy();
+        }
+
+        handle_type h { nullptr };
+    };
+
+    // Suspend the current coroutine and continue on the given executor.
+    // The executor must provide a post() function, which accepts a
+    // trivially copyable function object.
+    template<typename E>
+    auto resume_on(E& executor) noexcept
+    {
+        struct awaiter
+        {
+            E& e;
+
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { e.post([h] { h.resume(); }); }
+            void await_resume() noexcept { }
+        };
+        return awaiter { executor };
+    }
+}
+
+namespace jw::detail
+{
+    inline task<void> task_promise<void>::get_return_object() noexcept
+    {
+        return task<void> { std::coroutine_handle<task_promise>::from_promise(*this) };
+    }
+}
@@ -3,9 +3,19 @@
 
 #pragma once
 #include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <tuple>
 
 namespace jw::detail
 {
+    // Argument type used in the type-erased call thunk.  Small trivially
+    // copyable arguments that are taken by value are also passed by value
+    // through the thunk, so they can be kept in registers.
+    template<typename T>
+    using thunk_arg = std::conditional_t<not std::is_reference_v<T> and std::is_trivially_copyable_v<T>
+                                         and sizeof(T) <= 2 * sizeof(void*), T, T&&>;
+
     template<typename F> struct functor
     {
         F lambda;
@@ -14,7 +24,7 @@ namespace jw::detail
         static const functor* cast(const void* storage) noexcept { return static_cast<const functor*>(storage); }
 
         template<typename R, typename... A>
-        static R call(const void* self, A&&... args)
+        static R call(const void* self, thunk_arg<A>... args)
         {
             return cast(self)->lambda(std::forward<A>(args)...);
         }
@@ -53,29 +63,45 @@ namespace jw::detail
             };
             return &vtable;
         }
+    };
+
+    // Trivial functors need no vtable, they can be relocated with memcpy.
+    template<typename F>
+    inline constexpr bool is_trivial_functor = std::is_trivially_copyable_v<F> and std::is_trivially_destructible_v<F>;
 
-        template<std::size_t N>
-        static const functor_vtable* trivial() noexcept
+    template <typename T>
+    inline constexpr bool is_function_instance = false;
+
+    template<typename Sig>
+    struct thunk_type { };
+    template<typename R, typename... A>
+    struct thunk_type<R(A...)> { using type = R(*)(const void*, thunk_arg<A>...); };
+
+    template<typename Functor, typename Sig>
+    inline constexpr typename thunk_type<Sig>::type thunk_for = nullptr;
+    template<typename Functor, typename R, typename... A>
+    inline constexpr typename thunk_type<R(A...)>::type thunk_for<Functor, R(A...)> = &Functor::template call<R, A...>;
+
+    // Provides operator() for the I'th signature of an overload_function.
+    template<typename Self, std::size_t I, typename Sig>
+    struct overload_call;
+    template<typename Self, std::size_t I, typename R, typename... A>
+    struct overload_call<Self, I, R(A...)>
+    {
+        R operator()(A... args) const
         {
-            static constexpr functor_vtable vtable
-            {
-                trivial_destroy,
-                trivial_move<N>,
-                trivial_copy<N>
-            };
-            return &vtable;
+            const auto* const self = static_cast<const Self*>(this);
+            return std::get<I>(*self->table)(&self->storage, std::forward<A>(args)...);
         }
-
-    private:
-        static void trivial_destroy(void*) { }
-        template<std::size_t N>
-        static void trivial_move(void* to, void* from) { trivial_copy<N>(to, from); }
-        template<std::size_t N>
-        static void trivial_copy(void* to, const void* from) { std::memcpy(to, from, N); }
     };
 
-    template <typename T>
-    inline constexpr bool is_function_instance = false;
+    template<typename Self, typename Seq, typename... Sig>
+    struct overload_calls;
+    template<typename Self, std::size_t... I, typename... Sig>
+    struct overload_calls<Self, std::index_sequence<I...>, Sig...> : overload_call<Self, I, Sig>...
+    {
+        using overload_call<Self, I, Sig>::operator()...;
+    };
 
     template<typename>
     struct member_function_signature { };
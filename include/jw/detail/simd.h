@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+
+namespace jw::detail
+{
+    // Instruction set extensions that bulk operations may be compiled for.
+    enum class simd_level
+    {
+        none,
+        sse2,
+        avx2,
+        avx512
+    };
+
+    inline simd_level detect_simd_level() noexcept
+    {
+#       if defined(__i386__) or defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512bw")
+            and __builtin_cpu_supports("avx512vl") and __builtin_cpu_supports("avx512dq"))
+            return simd_level::avx512;
+        if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+        if (__builtin_cpu_supports("sse2")) return simd_level::sse2;
+#       endif
+        return simd_level::none;
+    }
+
+    // Detected once at startup.  Before that, this is zero-initialized to
+    // simd_level::none, so early callers safely get the generic code.
+    inline const simd_level simd_support = detect_simd_level();
+
+    // Each of these compiles the given kernel (a loop written in plain
+    // C++) for one instruction set, and lets the auto-vectorizer do the
+    // rest.  FP contraction is disabled, so that all variants produce
+    // identical results.
+    template<typename F>
+    [[gnu::flatten, gnu::optimize("tree-vectorize", "vect-cost-model=dynamic", "fp-contract=off")]]
+    inline void simd_generic(F& kernel) { kernel(); }
+
+#   if defined(__i386__) or defined(__x86_64__)
+    template<typename F>
+    [[gnu::target("sse2"), gnu::flatten, gnu::optimize("tree-vectorize", "vect-cost-model=dynamic", "fp-contract=off")]]
+    inline void simd_sse2(F& kernel) { kernel(); }
+
+    template<typename F>
+    [[gnu::target("avx2"), gnu::flatten, gnu::optimize("tree-vectorize", "vect-cost-model=dynamic", "fp-contract=off")]]
+    inline void simd_avx2(F& kernel) { kernel(); }
+
+    template<typename F>
+    [[gnu::target("avx512f,avx512bw,avx512vl,avx512dq"), gnu::flatten, gnu::optimize("tree-vectorize", "vect-cost-model=dynamic", "fp-contract=off")]]
+    inline void simd_avx512(F& kernel) { kernel(); }
+#   endif
+
+    // Run a kernel, compiled for the best instruction set available at
+    // runtime.
+    template<typename F>
+    inline void simd_dispatch(F&& kernel)
+    {
+        switch (simd_support)
+        {
+#       if defined(__i386__) or defined(__x86_64__)
+        case simd_level::avx512: return simd_avx512(kernel);
+        case simd_level::avx2:   return simd_avx2(kernel);
+        case simd_level::sse2:   return simd_sse2(kernel);
+#       endif
+        default:                 return simd_generic(kernel);
+        }
+    }
+}
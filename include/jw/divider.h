@@ -0,0 +1,146 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <bit>
+#include <span>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <concepts>
+#include <type_traits>
+#include <jw/fixed.h>
+#include <jw/detail/simd.h>
+
+namespace jw::detail
+{
+    template<typename T>
+    concept divider_int = std::integral<T> and not std::is_same_v<T, bool> and sizeof(T) <= 8;
+
+    // Returns floor(x * 2^N / d), modulo 2^N.  Requires x < d.
+    template<unsigned N>
+    constexpr std::uint64_t div_wide(std::uint64_t x, std::uint64_t d) noexcept
+    {
+        if constexpr (N <= 32) return (x << N) / d;
+        else return udiv_wide(x, 0, d);
+    }
+}
+
+namespace jw
+{
+    // Divides integers by a runtime-constant divisor, using a precomputed
+    // reciprocal.  Each division takes one multiplication, and a few
+    // shifts and additions.  Results are identical to the built-in
+    // division operator (rounded towards zero).  Based on: T. Granlund and
+    // P. L. Montgomery, "Division by Invariant Integers using
+    // Multiplication", 1994.
+    template<detail::divider_int T>
+    struct divider
+    {
+        using type = T;
+
+        constexpr divider(T d) noexcept : d { d }
+        {
+            assert(d != 0);
+            using U = std::make_unsigned_t<T>;
+            if constexpr (std::is_unsigned_v<T>)
+            {
+                const unsigned l = std::bit_width(static_cast<U>(d - 1));
+                const std::uint64_t x = (l == 64 ? 0 : std::uint64_t { 1 } << l) - d;
+                magic = static_cast<T>(detail::div_wide<N>(x, d) + 1);
+                shift1 = l > 0;
+                shift2 = l > 0 ? l - 1 : 0;
+            }
+            else
+            {
+                const U ad = d < 0 ? 0 - static_cast<U>(d) : static_cast<U>(d);
+                const unsigned l = std::max<unsigned>(std::bit_width(static_cast<U>(ad - 1)), 1);
+                std::uint64_t q;
+                if constexpr (N <= 32) q = (std::uint64_t { 1 } << (N + l - 1)) / ad;
+                else q = ad == 1 ? 0 : detail::div_wide<N>(std::uint64_t { 1 } << (l - 1), ad);
+                magic = static_cast<T>(static_cast<U>(q + 1));
+                shift1 = l - 1;
+                sign = d < 0 ? -1 : 0;
+            }
+        }
+
+        constexpr T divide(T n) const noexcept
+        {
+            if constexpr (std::is_unsigned_v<T>)
+            {
+                const T t = detail::mulhi(magic, n);
+                return static_cast<T>(static_cast<T>(t + static_cast<T>(static_cast<T>(n - t) >> shift1)) >> shift2);
+            }
+            else
+            {
+                using U = std::make_unsigned_t<T>;
+                T q = static_cast<T>(static_cast<U>(n) + static_cast<U>(detail::mulhi(magic, n)));
+                q = static_cast<T>((q >> shift1) - (n >> (N - 1)));
+                return static_cast<T>((q ^ sign) - sign);
+            }
+        }
+
+        constexpr T divisor() const noexcept { return d; }
+
+        friend constexpr T operator/(T n, const divider& d) noexcept { return d.divide(n); }
+
+    private:
+        static constexpr unsigned N = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+
+        T magic;
+        T d;
+        std::uint8_t shift1;
+        std::uint8_t shift2 { 0 };
+        T sign { 0 };
+    };
+
+    // Divides fixed-point values by a runtime-constant fixed-point divisor.
+    // The dividend is widened and shifted first, so no precision is lost,
+    // and the result is subject to the overflow policy of Fx.  Supported
+    // for types of up to 32 bits.
+    template<typename Fx> requires (is_fixed<Fx> and sizeof(typename Fx::type) <= 4)
+    struct fixed_divider
+    {
+        using type = Fx;
+
+        constexpr fixed_divider(const Fx& d) noexcept : div { d.value } { }
+
+        constexpr Fx divide(const Fx& n) const
+        {
+            using T = typename Fx::type;
+            const auto q = div.divide(static_cast<larger_t<T>>(n.value) << Fx::frac_bits);
+            return Fx::make(detail::fixed_narrow<Fx::overflow_policy, T>(q));
+        }
+
+        constexpr Fx divisor() const noexcept { return Fx::make(div.divisor()); }
+
+        friend constexpr Fx operator/(const Fx& n, const fixed_divider& d) { return d.divide(n); }
+
+    private:
+        divider<larger_t<typename Fx::type>> div;
+    };
+
+    // Divide a fixed-point value by a runtime-constant integer.
+    template<typename T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> operator/(const fixed<T, F, P>& x, const divider<T>& d)
+    {
+        if constexpr (std::is_signed_v<T> and P != fixed_overflow::wrap)
+            if (x.value == std::numeric_limits<T>::min() and d.divisor() == -1)
+                return fixed<T, F, P>::make(detail::fixed_overflowed<P, T>(true));
+        return fixed<T, F, P>::make(d.divide(x.value));
+    }
+
+    // dst[i] = a[i] / d, where d is a divider, fixed_divider, or any other
+    // divisor type.
+    template<typename D, typename A, typename Div>
+    void divide(std::span<D> dst, std::span<A> a, const Div& d)
+    {
+        assert(a.size() == dst.size());
+        detail::simd_dispatch([p = dst.data(), x = a.data(), n = dst.size(), d]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                p[i] = x[i] / d;
+        });
+    }
+}
@@ -6,21 +6,38 @@
 #include <type_traits>
 #include <limits>
 #include <concepts>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
 #include <jw/math.h>
 
 namespace jw::detail
 {
+#   ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 int128_t;
+    __extension__ typedef unsigned __int128 uint128_t;
+#   endif
+
     template<std::size_t> struct larger_int { using type = void; };
     template<> struct larger_int<1> { using type = std::int16_t; };
     template<> struct larger_int<2> { using type = std::int32_t; };
     template<> struct larger_int<4> { using type = std::int64_t; };
-    template<> struct larger_int<8> { using type = std::int64_t; };
 
     template<std::size_t> struct larger_uint { using type = void; };
     template<> struct larger_uint<1> { using type = std::uint16_t; };
     template<> struct larger_uint<2> { using type = std::uint32_t; };
     template<> struct larger_uint<4> { using type = std::uint64_t; };
+
+    // 128-bit integers are only used if the standard library recognizes
+    // them as integral types (in gnu++ mode).  Otherwise, 64-bit fixed
+    // types fall back to the portable code paths below.
+#   ifdef __SIZEOF_INT128__
+    template<> struct larger_int<8> { using type = std::conditional_t<std::is_integral_v<int128_t>, int128_t, std::int64_t>; };
+    template<> struct larger_uint<8> { using type = std::conditional_t<std::is_integral_v<uint128_t>, uint128_t, std::uint64_t>; };
+#   else
+    template<> struct larger_int<8> { using type = std::int64_t; };
     template<> struct larger_uint<8> { using type = std::uint64_t; };
+#   endif
 }
 
 namespace jw
@@ -36,14 +53,250 @@ namespace jw
     concept same_sign_int = std::is_signed_v<T> == std::is_signed_v<U>
                             and std::integral<T> and std::integral<U>;
 
-    // Fixed-point data type
-    template<std::integral T, std::size_t F>
+    // Behaviour of fixed-point arithmetic when the result does not fit.
+    // Operations on fixed types with different policies use the strictest
+    // of both.
+    enum class fixed_overflow
+    {
+        // Discard the upper bits of the result.
+        wrap,
+
+        // Clamp to the nearest representable value.
+        saturate,
+
+        // Throw fixed_overflow_error.
+        trap
+    };
+
+    // Exception type thrown on overflow of a fixed type with the "trap"
+    // overflow policy.
+    struct fixed_overflow_error : std::overflow_error
+    {
+        fixed_overflow_error() : overflow_error { "fixed-point overflow" } { }
+        fixed_overflow_error(const fixed_overflow_error&) noexcept = default;
+        fixed_overflow_error& operator=(const fixed_overflow_error&) noexcept = default;
+    };
+
+    template<std::integral T, std::size_t F, fixed_overflow = fixed_overflow::wrap>
+    struct fixed;
+}
+
+namespace jw::detail
+{
+    // True if larger_t<T> is actually wider than T.
+    template<typename T>
+    concept has_larger_int = requires { requires sizeof(larger_t<T>) > sizeof(T); };
+
+    // Widest type available for intermediate results of T.
+    template<std::integral T>
+    using wider_t = std::conditional_t<has_larger_int<T>, larger_t<T>, T>;
+
+    // Upper half of the full product of two unsigned integers.
+    template<std::unsigned_integral T>
+    constexpr T mulhi(T a, T b) noexcept
+    {
+        constexpr unsigned N = std::numeric_limits<T>::digits;
+        if constexpr (N <= 32) return static_cast<T>((static_cast<std::uint64_t>(a) * b) >> N);
+        else
+        {
+#           ifdef __SIZEOF_INT128__
+            return static_cast<T>((static_cast<uint128_t>(a) * b) >> 64);
+#           else
+            const std::uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+            const std::uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+            const std::uint64_t p01 = a0 * b1, p10 = a1 * b0;
+            const std::uint64_t mid = ((a0 * b0) >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+            return a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#           endif
+        }
+    }
+
+    // Upper half of the full product of two signed integers.
+    template<std::signed_integral T>
+    constexpr T mulhi(T a, T b) noexcept
+    {
+        constexpr unsigned N = std::numeric_limits<T>::digits + 1;
+        if constexpr (N <= 32) return static_cast<T>((static_cast<std::int64_t>(a) * b) >> N);
+        else
+        {
+            using U = std::make_unsigned_t<T>;
+            const U hi = mulhi<U>(a, b) - (a < 0 ? static_cast<U>(b) : 0) - (b < 0 ? static_cast<U>(a) : 0);
+            return static_cast<T>(hi);
+        }
+    }
+
+    // Divide (hi * 2^64 + lo) by d.  Requires hi < d.
+    constexpr std::uint64_t udiv_wide(std::uint64_t hi, std::uint64_t lo, std::uint64_t d) noexcept
+    {
+#       ifdef __SIZEOF_INT128__
+        return static_cast<std::uint64_t>(((static_cast<uint128_t>(hi) << 64) | lo) / d);
+#       else
+        // Restoring division.  The quotient bits are shifted into lo.
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            const bool carry = hi >> 63;
+            hi = (hi << 1) | (lo >> 63);
+            lo <<= 1;
+            if (carry or hi >= d)
+            {
+                hi -= d;
+                lo |= 1;
+            }
+        }
+        return lo;
+#       endif
+    }
+
+    template<fixed_overflow P, std::integral T>
+    constexpr T fixed_overflowed(bool positive)
+    {
+        if constexpr (P == fixed_overflow::trap) throw fixed_overflow_error { };
+        else return positive ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+    }
+
+    // Convert an intermediate result to T, according to overflow policy P.
+    // Saturation is written as a clamp in the intermediate type, which
+    // compiles to conditional moves, and vectorizes to min/max.
+    template<fixed_overflow P, std::integral T, std::integral I>
+    constexpr T fixed_narrow(I v)
+    {
+        constexpr auto min = std::numeric_limits<T>::min();
+        constexpr auto max = std::numeric_limits<T>::max();
+        if constexpr (P == fixed_overflow::saturate and std::in_range<I>(min) and std::in_range<I>(max))
+            return static_cast<T>(std::clamp<I>(v, min, max));
+        else if constexpr (P != fixed_overflow::wrap)
+        {
+            if (std::cmp_less(v, min)) return fixed_overflowed<P, T>(false);
+            if (std::cmp_greater(v, max)) return fixed_overflowed<P, T>(true);
+        }
+        return static_cast<T>(v);
+    }
+
+    template<fixed_overflow P, std::integral T>
+    constexpr T fixed_add(T a, T b)
+    {
+        using W = std::make_signed_t<wider_t<T>>;
+        if constexpr (P == fixed_overflow::wrap)
+            return static_cast<T>(static_cast<std::make_unsigned_t<T>>(a) + static_cast<std::make_unsigned_t<T>>(b));
+        else if constexpr (sizeof(W) > sizeof(T))
+            return fixed_narrow<P, T>(static_cast<W>(a) + static_cast<W>(b));
+        else
+        {
+            T r;
+            if (__builtin_add_overflow(a, b, &r)) return fixed_overflowed<P, T>(b > 0);
+            return r;
+        }
+    }
+
+    template<fixed_overflow P, std::integral T>
+    constexpr T fixed_sub(T a, T b)
+    {
+        using W = std::make_signed_t<wider_t<T>>;
+        if constexpr (P == fixed_overflow::wrap)
+            return static_cast<T>(static_cast<std::make_unsigned_t<T>>(a) - static_cast<std::make_unsigned_t<T>>(b));
+        else if constexpr (sizeof(W) > sizeof(T))
+            return fixed_narrow<P, T>(static_cast<W>(a) - static_cast<W>(b));
+        else
+        {
+            T r;
+            if (__builtin_sub_overflow(a, b, &r)) return fixed_overflowed<P, T>(b < 0);
+            return r;
+        }
+    }
+
+    // Multiply two fixed-point values with F fractional bits.  The product
+    // is computed at full precision, for types of up to 64 bits.
+    template<fixed_overflow P, std::size_t F, std::integral T>
+    constexpr T fixed_mul(T a, T b)
+    {
+        if constexpr (has_larger_int<T>)
+        {
+            using L = larger_t<T>;
+            return fixed_narrow<P, T>(static_cast<L>(a) * static_cast<L>(b) >> F);
+        }
+        else if constexpr (sizeof(T) == 8)
+        {
+            // Without a 128-bit type, shift the two halves of the product.
+            using U = std::uint64_t;
+            const U lo = static_cast<U>(a) * static_cast<U>(b);
+            const T hi = mulhi(a, b);
+            T r = hi, h = 0;
+            if constexpr (F == 0) r = static_cast<T>(lo), h = hi;
+            else if constexpr (F < 64) r = static_cast<T>((static_cast<U>(hi) << (64 - F)) | (lo >> F)), h = hi >> F;
+            if constexpr (P != fixed_overflow::wrap)
+            {
+                // The result fits if h is the sign extension of r.
+                T sign = 0;
+                if constexpr (std::is_signed_v<T>) sign = r >> 63;
+                if (h != sign) return fixed_overflowed<P, T>(h >= 0);
+            }
+            return r;
+        }
+        else
+        {
+            T r;
+            [[maybe_unused]] const bool o = __builtin_mul_overflow(a, b, &r);
+            if constexpr (P != fixed_overflow::wrap)
+                if (o) return fixed_overflowed<P, T>((a < 0) == (b < 0));
+            return r >> F;
+        }
+    }
+
+    template<fixed_overflow P, std::size_t F, std::integral T>
+    constexpr T fixed_div(T a, T b)
+    {
+        if constexpr (sizeof(T) == 8 and F < 64)
+        {
+            // Avoid the 128-bit division if a << F fits in 64 bits.
+            constexpr T limit = std::numeric_limits<T>::max() >> F;
+            bool fits = a <= limit;
+            if constexpr (std::is_signed_v<T>) fits &= a >= -limit;
+            if (fits) return (a << F) / b;
+        }
+
+        if constexpr (has_larger_int<T>)
+            return fixed_narrow<P, T>((static_cast<larger_t<T>>(a) << F) / b);
+        else if constexpr (sizeof(T) == 8)
+        {
+            // Long division of the magnitudes, without a 128-bit type.
+            using U = std::uint64_t;
+            bool negative = false;
+            U ua = a, ub = b;
+            if constexpr (std::is_signed_v<T>)
+            {
+                negative = (a < 0) != (b < 0);
+                if (a < 0) ua = 0 - ua;
+                if (b < 0) ub = 0 - ub;
+            }
+            U hi = 0, lo = 0;
+            if constexpr (F == 0) lo = ua;
+            else if constexpr (F < 64) hi = ua >> (64 - F), lo = ua << F;
+            else hi = ua;
+            [[maybe_unused]] const bool o = hi >= ub;
+            const U q = udiv_wide(hi % ub, lo, ub);
+            if constexpr (P != fixed_overflow::wrap)
+            {
+                const U max = static_cast<U>(std::numeric_limits<T>::max()) + negative;
+                if (o or q > max) return fixed_overflowed<P, T>(not negative);
+            }
+            return static_cast<T>(negative ? 0 - q : q);
+        }
+        else return fixed_narrow<P, T>((a << F) / b);
+    }
+}
+
+namespace jw
+{
+    // Fixed-point data type.  The overflow policy P determines the result
+    // of arithmetic and conversions that exceed the range of T.
+    template<std::integral T, std::size_t F, fixed_overflow P>
     struct fixed
     {
         using type = T;
         static constexpr std::size_t bits = std::numeric_limits<T>::digits;
         static constexpr std::size_t int_bits = bits - F;
         static constexpr std::size_t frac_bits = F;
+        static constexpr fixed_overflow overflow_policy = P;
         static_assert(frac_bits <= bits);
 
         T value;
@@ -51,16 +304,16 @@ namespace jw
         static constexpr fixed make(T value) noexcept { return fixed { noshift, value }; }
 
         template<std::floating_point U>
-        constexpr fixed(U v) noexcept : value { static_cast<T>(round(v * (1ULL << F))) } { }
+        constexpr fixed(U v) noexcept(P != fixed_overflow::trap) : value { from_float(round(v * scale<U>)) } { }
 
         template<std::integral U>
-        constexpr fixed(U v) noexcept : value { static_cast<T>(v) << F } { }
+        constexpr fixed(U v) noexcept(P != fixed_overflow::trap) : fixed { convert(fixed<U, 0, P>::make(v)) } { }
 
-        template<same_sign_int<T> U, std::size_t G>
-        constexpr fixed(const fixed<U, G>& v) noexcept : fixed { convert(v) } { }
+        template<same_sign_int<T> U, std::size_t G, fixed_overflow Q>
+        constexpr fixed(const fixed<U, G, Q>& v) noexcept(P != fixed_overflow::trap) : fixed { convert(v) } { }
 
-        template<std::integral U, std::size_t G>
-        constexpr explicit fixed(const fixed<U, G>& v) noexcept : fixed { convert(v) } { }
+        template<std::integral U, std::size_t G, fixed_overflow Q>
+        constexpr explicit fixed(const fixed<U, G, Q>& v) noexcept(P != fixed_overflow::trap) : fixed { convert(v) } { }
 
         constexpr fixed() noexcept = default;
         constexpr fixed(const fixed&) noexcept = default;
@@ -70,47 +323,58 @@ namespace jw
 
         template<typename U> constexpr fixed& operator =(U v) { *this  = fixed { v }; return *this; }
 
-        constexpr fixed& operator+=(const fixed& v) { value += v.value; return *this; }
-        constexpr fixed& operator-=(const fixed& v) { value -= v.value; return *this; }
-        constexpr fixed& operator*=(const fixed& v) { value *= v.value; value >>= F; return *this; }
-        constexpr fixed& operator/=(const fixed& v) { value <<= F; value /= v.value; return *this; }
+        constexpr fixed& operator+=(const fixed& v) { value = detail::fixed_add<P>(value, v.value); return *this; }
+        constexpr fixed& operator-=(const fixed& v) { value = detail::fixed_sub<P>(value, v.value); return *this; }
+        constexpr fixed& operator*=(const fixed& v) { value = detail::fixed_mul<P, F>(value, v.value); return *this; }
+        constexpr fixed& operator/=(const fixed& v) { value = detail::fixed_div<P, F>(value, v.value); return *this; }
 
-        template<same_sign_int<T> U, std::size_t G> friend constexpr auto operator+(const fixed& f, const fixed<U, G>& v)
+        template<same_sign_int<T> U, std::size_t G, fixed_overflow Q> friend constexpr auto operator+(const fixed& f, const fixed<U, G, Q>& v)
         {
-            fixed<max_t<T, U>, std::max(F, G)> a { f }, b { v };
+            fixed<max_t<T, U>, std::max(F, G), std::max(P, Q)> a { f }, b { v };
             return a += b;
         }
-        template<same_sign_int<T> U, std::size_t G> friend constexpr auto operator-(const fixed& f, const fixed<U, G>& v)
+        template<same_sign_int<T> U, std::size_t G, fixed_overflow Q> friend constexpr auto operator-(const fixed& f, const fixed<U, G, Q>& v)
         {
-            fixed<max_t<T, U>, std::max(F, G)> a { f }, b { v };
+            fixed<max_t<T, U>, std::max(F, G), std::max(P, Q)> a { f }, b { v };
             return a -= b;
         }
-        template<same_sign_int<T> U, std::size_t G> friend constexpr auto operator*(const fixed& f, const fixed<U, G>& v)
+        template<same_sign_int<T> U, std::size_t G, fixed_overflow Q> friend constexpr auto operator*(const fixed& f, const fixed<U, G, Q>& v)
         {
-            larger_t<max_t<T, U>> a { f.value };
-            return fixed<larger_t<max_t<T, U>>, F + G>::make(a * v.value);
+            if constexpr (detail::has_larger_int<max_t<T, U>>)
+            {
+                larger_t<max_t<T, U>> a { f.value };
+                return fixed<larger_t<max_t<T, U>>, F + G, std::max(P, Q)>::make(a * v.value);
+            }
+            else
+            {
+                // No type can hold the full product, so round it to the
+                // larger precision.
+                fixed<max_t<T, U>, std::max(F, G), std::max(P, Q)> a { f }, b { v };
+                return a *= b;
+            }
         }
-        template<same_sign_int<T> U, std::size_t G> friend constexpr auto operator/(const fixed& f, const fixed<U, G>& v)
+        template<same_sign_int<T> U, std::size_t G, fixed_overflow Q> friend constexpr auto operator/(const fixed& f, const fixed<U, G, Q>& v)
         {
             if constexpr (static_cast<signed>(F - G) <= 0)
                 return (static_cast<larger_t<T>>(f.value) << -(F - G)) / v.value;
-            else return fixed<max_t<T, U>, F - G>::make(f.value / v.value);
+            else return fixed<max_t<T, U>, F - G, std::max(P, Q)>::make(f.value / v.value);
         }
 
-        template<std::integral U> constexpr fixed& operator+=(U v) { value += static_cast<larger_t<U>>(v) << F; return *this; }
-        template<std::integral U> constexpr fixed& operator-=(U v) { value -= static_cast<larger_t<U>>(v) << F; return *this; }
-        template<std::integral U> constexpr fixed& operator*=(U v) { value *= v; return *this; }
-        template<std::integral U> constexpr fixed& operator/=(U v) { value /= v; return *this; }
+        // Integer operands are converted to this fixed type first.
+        template<std::integral U> constexpr fixed& operator+=(U v) { return *this += fixed { v }; }
+        template<std::integral U> constexpr fixed& operator-=(U v) { return *this -= fixed { v }; }
+        template<std::integral U> constexpr fixed& operator*=(U v) { value = detail::fixed_mul<P, 0>(value, detail::fixed_narrow<P, T>(v)); return *this; }
+        template<std::integral U> constexpr fixed& operator/=(U v) { value = detail::fixed_narrow<P, T>(value / v); return *this; }
 
-        template<std::floating_point U> constexpr fixed& operator+=(U v) { value = round(value + v * (1 << F)); return *this; }
-        template<std::floating_point U> constexpr fixed& operator-=(U v) { value = round(value - v * (1 << F)); return *this; }
-        template<std::floating_point U> constexpr fixed& operator*=(U v) { value = round(value * v); return *this; }
-        template<std::floating_point U> constexpr fixed& operator/=(U v) { value = round(value / v); return *this; }
+        template<std::floating_point U> constexpr fixed& operator+=(U v) { value = from_float(round(value + v * scale<U>)); return *this; }
+        template<std::floating_point U> constexpr fixed& operator-=(U v) { value = from_float(round(value - v * scale<U>)); return *this; }
+        template<std::floating_point U> constexpr fixed& operator*=(U v) { value = from_float(round(value * v)); return *this; }
+        template<std::floating_point U> constexpr fixed& operator/=(U v) { value = from_float(round(value / v)); return *this; }
 
-        template<std::integral U> friend constexpr auto operator+(const fixed& f, U v) { return fixed<max_t<T, U>, F> { f } += v; }
-        template<std::integral U> friend constexpr auto operator-(const fixed& f, U v) { return fixed<T, F> { f } -= v; }
-        template<std::integral U> friend constexpr auto operator*(const fixed& f, U v) { return fixed<larger_t<T>, F> { f } *= v; }
-        template<std::integral U> friend constexpr auto operator/(const fixed& f, U v) { return fixed<T, F> { f } /= v; }
+        template<std::integral U> friend constexpr auto operator+(const fixed& f, U v) { return fixed<max_t<T, U>, F, P> { f } += v; }
+        template<std::integral U> friend constexpr auto operator-(const fixed& f, U v) { return fixed { f } -= v; }
+        template<std::integral U> friend constexpr auto operator*(const fixed& f, U v) { return fixed<detail::wider_t<T>, F, P> { f } *= v; }
+        template<std::integral U> friend constexpr auto operator/(const fixed& f, U v) { return fixed { f } /= v; }
 
         template<std::integral U> friend constexpr auto operator+(U v, const fixed& f) { return f + v; }
         template<std::integral U> friend constexpr auto operator-(U v, const fixed& f) { return fixed { v } -= f; }
@@ -128,48 +392,105 @@ namespace jw
         friend constexpr fixed operator>>(const fixed& f, unsigned v) { return fixed { f } >>= v; }
         friend constexpr fixed operator<<(const fixed& f, unsigned v) { return fixed { f } <<= v; }
 
-        template<std::floating_point U> constexpr operator U() const noexcept { return static_cast<U>(value) / (1 << F); }
-        template<std::integral U> constexpr explicit operator U() const noexcept { return static_cast<U>(value) >> F; }
+        template<std::floating_point U> constexpr operator U() const noexcept { return static_cast<U>(value) / scale<U>; }
+        template<std::integral U> constexpr explicit operator U() const noexcept { return static_cast<U>(value >> F); }
 
     private:
-        template<typename U, std::size_t G>
-        static constexpr fixed convert(const fixed<U, G>& v) noexcept
+        template<std::integral, std::size_t, fixed_overflow> friend struct fixed;
+
+        template<typename U, std::size_t G, fixed_overflow Q>
+        static constexpr fixed convert(const fixed<U, G, Q>& v) noexcept(P != fixed_overflow::trap)
         {
             using Max = max_t<T, U>;
             using Intermediate = std::conditional_t<std::is_signed_v<T>, std::make_signed_t<Max>, std::make_unsigned_t<Max>>;
-            return make(shl(static_cast<Intermediate>(v.value), F - G));
+            using limits = std::numeric_limits<T>;
+            if constexpr (P == fixed_overflow::wrap)
+                return make(shl(static_cast<Intermediate>(v.value), static_cast<int>(F) - static_cast<int>(G)));
+            else if constexpr (F >= G)
+            {
+                // Check the range before shifting, so no bits are lost.
+                constexpr auto shift = F - G;
+                if (std::cmp_less(v.value, limits::min() >> shift)) return make(detail::fixed_overflowed<P, T>(false));
+                if (std::cmp_greater(v.value, limits::max() >> shift)) return make(detail::fixed_overflowed<P, T>(true));
+                return make(static_cast<T>(static_cast<T>(v.value) << shift));
+            }
+            else return make(detail::fixed_narrow<P, T>(v.value >> (G - F)));
+        }
+
+        // 2^F, exact for any F.
+        template<std::floating_point U>
+        static constexpr U scale = [] { U x = 1; for (std::size_t i = 0; i < F; ++i) x *= 2; return x; }();
+
+        template<std::floating_point U>
+        static constexpr T from_float(U v) noexcept(P != fixed_overflow::trap)
+        {
+            if constexpr (P != fixed_overflow::wrap)
+            {
+                constexpr U min = static_cast<U>(std::numeric_limits<T>::min());
+                constexpr U max = static_cast<U>(std::numeric_limits<T>::max() / 2 + 1) * 2;
+                if (v < min) return detail::fixed_overflowed<P, T>(false);
+                if (v >= max) return detail::fixed_overflowed<P, T>(true);
+            }
+            return static_cast<T>(v);
         }
 
         struct noshift_t { } constexpr inline static noshift { };
         template<std::integral U> constexpr fixed(noshift_t, U v) noexcept : value { static_cast<T>(v) } { }
     };
 
+    template<typename T>
+    inline constexpr bool is_fixed = false;
+
+    template<typename T, std::size_t F, fixed_overflow P>
+    inline constexpr bool is_fixed<fixed<T, F, P>> = true;
+
+    template<std::integral T, std::size_t F>
+    using saturating_fixed = fixed<T, F, fixed_overflow::saturate>;
+
     // Convert fixed-point type to integer with rounding.
-    template<typename T, std::size_t F>
-    constexpr T round(const fixed<T, F>& f) noexcept { return (f.value + (1 << (F - 1))) >> F; }
+    template<typename T, std::size_t F, fixed_overflow P>
+    constexpr T round(const fixed<T, F, P>& f) noexcept
+    {
+        if constexpr (F == 0) return f.value;
+        else return (f.value >> F) + ((f.value >> (F - 1)) & 1);
+    }
 
-    // Convert fixed-point to fixed-point with rounding.
-    template<typename Fx, typename T, std::size_t F>
-    constexpr Fx round_to(const fixed<T, F>& f) noexcept
+    // Convert fixed-point to fixed-point with rounding.  The overflow
+    // policy of the destination type applies.
+    template<typename Fx, typename T, std::size_t F, fixed_overflow P>
+    constexpr Fx round_to(const fixed<T, F, P>& f) noexcept(Fx::overflow_policy != fixed_overflow::trap)
     {
         using T2 = typename Fx::type;
         using Max = max_t<T, T2>;
         using Intermediate = std::conditional_t<std::is_signed_v<T2>, std::make_signed_t<Max>, std::make_unsigned_t<Max>>;
         constexpr auto N = Fx::frac_bits;
-        constexpr int round_bits = F - N - 1;
-        constexpr Intermediate rounding = round_bits < 0 ? 0 : 1 << round_bits;
-        return Fx::make(shl(static_cast<Intermediate>(f.value) + rounding, N - F));
+        constexpr int shift = static_cast<int>(N) - static_cast<int>(F);
+        if constexpr (shift >= 0)
+        {
+            if constexpr (Fx::overflow_policy == fixed_overflow::wrap)
+                return Fx::make(shl(static_cast<Intermediate>(f.value), shift));
+            else return Fx { f };
+        }
+        else
+        {
+            // Round half up.  Adding the rounding bit after shifting can't
+            // overflow the intermediate type.
+            const auto v = static_cast<Intermediate>(f.value);
+            const Intermediate r = (v >> -shift) + ((v >> (-shift - 1)) & 1);
+            if constexpr (Fx::overflow_policy == fixed_overflow::wrap) return Fx::make(r);
+            else return Fx { fixed<Intermediate, N>::make(r) };
+        }
     }
 
     // Convert fixed-point to N-bits fixed-point with rounding.
-    template<std::size_t N, typename T, std::size_t F>
-    constexpr fixed<T, N> round_to(const fixed<T, F>& f) noexcept
+    template<std::size_t N, typename T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, N, P> round_to(const fixed<T, F, P>& f) noexcept(P != fixed_overflow::trap)
     {
-        return round_to<fixed<T, N>>(f);
+        return round_to<fixed<T, N, P>>(f);
     }
 
-    template<typename T, std::size_t F, typename U, std::size_t G>
-    constexpr bool operator ==(const fixed<T, F>& l, const fixed<U, G>& r) noexcept
+    template<typename T, std::size_t F, fixed_overflow P, typename U, std::size_t G, fixed_overflow Q>
+    constexpr bool operator ==(const fixed<T, F, P>& l, const fixed<U, G, Q>& r) noexcept
     {
         if constexpr (F == G)
             return l.value == r.value;
@@ -182,14 +503,14 @@ namespace jw
         else return r == l;
     }
 
-    template<typename T, std::size_t F, typename U, std::size_t G>
-    constexpr bool operator !=(const fixed<T, F>& l, const fixed<U, G>& r) noexcept
+    template<typename T, std::size_t F, fixed_overflow P, typename U, std::size_t G, fixed_overflow Q>
+    constexpr bool operator !=(const fixed<T, F, P>& l, const fixed<U, G, Q>& r) noexcept
     {
         return not (l == r);
     }
 
-    template<typename T, std::size_t F, typename U, std::size_t G>
-    constexpr bool operator <(const fixed<T, F>& l, const fixed<U, G>& r) noexcept
+    template<typename T, std::size_t F, fixed_overflow P, typename U, std::size_t G, fixed_overflow Q>
+    constexpr bool operator <(const fixed<T, F, P>& l, const fixed<U, G, Q>& r) noexcept
     {
         if constexpr (F == G)
             return l.value < r.value;
@@ -209,51 +530,51 @@ namespace jw
         }
     }
 
-    template<typename T, std::size_t F, typename U, std::size_t G>
-    constexpr bool operator >(const fixed<T, F>& l, const fixed<U, G>& r) noexcept
+    template<typename T, std::size_t F, fixed_overflow P, typename U, std::size_t G, fixed_overflow Q>
+    constexpr bool operator >(const fixed<T, F, P>& l, const fixed<U, G, Q>& r) noexcept
     {
         return r < l;
     }
 
-    template<typename T, std::size_t F, typename U, std::size_t G>
-    constexpr bool operator <=(const fixed<T, F>& l, const fixed<U, G>& r) noexcept
+    template<typename T, std::size_t F, fixed_overflow P, typename U, std::size_t G, fixed_overflow Q>
+    constexpr bool operator <=(const fixed<T, F, P>& l, const fixed<U, G, Q>& r) noexcept
     {
         return not (l > r);
     }
 
-    template<typename T, std::size_t F, typename U, std::size_t G>
-    constexpr bool operator >=(const fixed<T, F>& l, const fixed<U, G>& r) noexcept
+    template<typename T, std::size_t F, fixed_overflow P, typename U, std::size_t G, fixed_overflow Q>
+    constexpr bool operator >=(const fixed<T, F, P>& l, const fixed<U, G, Q>& r) noexcept
     {
         return not (l < r);
     }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator ==(const fixed<T, F>& l, const U& r) noexcept { return l == fixed<U, 0> { r }; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator ==(const fixed<T, F, P>& l, const U& r) noexcept { return l == fixed<U, 0> { r }; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator !=(const fixed<T, F>& l, const U& r) noexcept { return not (l == r); }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator !=(const fixed<T, F, P>& l, const U& r) noexcept { return not (l == r); }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator <(const fixed<T, F>& l, const U& r) noexcept { return l < fixed<U, 0> { r }; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator <(const fixed<T, F, P>& l, const U& r) noexcept { return l < fixed<U, 0> { r }; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator <(const U& l, const fixed<T, F>& r) noexcept { return fixed<U, 0> { l } < r; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator <(const U& l, const fixed<T, F, P>& r) noexcept { return fixed<U, 0> { l } < r; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator >(const fixed<T, F>& l, const U& r) noexcept { return l > fixed<U, 0> { r }; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator >(const fixed<T, F, P>& l, const U& r) noexcept { return l > fixed<U, 0> { r }; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator >(const U& l, const fixed<T, F>& r) noexcept { return fixed<U, 0> { l } > r; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator >(const U& l, const fixed<T, F, P>& r) noexcept { return fixed<U, 0> { l } > r; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator <=(const fixed<T, F>& l, const U& r) noexcept { return l <= fixed<U, 0> { r }; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator <=(const fixed<T, F, P>& l, const U& r) noexcept { return l <= fixed<U, 0> { r }; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator <=(const U& l, const fixed<T, F>& r) noexcept { return fixed<U, 0> { l } <= r; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator <=(const U& l, const fixed<T, F, P>& r) noexcept { return fixed<U, 0> { l } <= r; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator >=(const fixed<T, F>& l, const U& r) noexcept { return l >= fixed<U, 0> { r }; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator >=(const fixed<T, F, P>& l, const U& r) noexcept { return l >= fixed<U, 0> { r }; }
 
-    template<typename T, std::size_t F, std::integral U>
-    constexpr bool operator >=(const U& l, const fixed<T, F>& r) noexcept { return fixed<U, 0> { l } >= r; }
+    template<typename T, std::size_t F, fixed_overflow P, std::integral U>
+    constexpr bool operator >=(const U& l, const fixed<T, F, P>& r) noexcept { return fixed<U, 0> { l } >= r; }
 }
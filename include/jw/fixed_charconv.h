@@ -0,0 +1,277 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <algorithm>
+#include <jw/fixed.h>
+#if __has_include(<format>)
+#include <format>
+#endif
+
+// Conversion between fixed-point values and decimal strings, in integer
+// arithmetic only.  Every fixed-point value has a finite decimal
+// representation, so these conversions are exact.  The format is always
+// [-]digits[.digits], without exponent.
+
+namespace jw::detail
+{
+    struct fixed_decimal
+    {
+        bool negative;
+        std::uint64_t integer;
+        std::uint64_t fraction;     // Fractional part, with F bits.
+    };
+
+    template<std::size_t F>
+    inline constexpr std::uint64_t fraction_mask = F == 64 ? ~std::uint64_t { 0 } : (std::uint64_t { 1 } << (F % 64)) - 1;
+
+    template<typename T, std::size_t F, fixed_overflow P>
+    constexpr fixed_decimal split_fixed(const fixed<T, F, P>& x) noexcept
+    {
+        static_assert(sizeof(T) <= 8, "decimal conversion is limited to 64-bit fixed types");
+        const bool negative = x.value < 0;
+        const auto v = static_cast<std::uint64_t>(static_cast<std::int64_t>(x.value));
+        const std::uint64_t magnitude = negative ? 0 - v : v;
+        if constexpr (F == 64) return { negative, 0, magnitude };
+        else return { negative, magnitude >> F, magnitude & fraction_mask<F> };
+    }
+
+    // Multiply a fraction with F bits by 10.  Returns the next decimal
+    // digit, and leaves the remainder in frac.
+    template<std::size_t F>
+    constexpr unsigned next_decimal_digit(std::uint64_t& frac) noexcept
+    {
+        const std::uint64_t lo = frac * 10;
+        const std::uint64_t hi = ((frac >> 32) * 10 + (((frac & 0xffffffff) * 10) >> 32)) >> 32;
+        frac = lo & fraction_mask<F>;
+        if constexpr (F == 0) return 0;
+        else if constexpr (F == 64) return hi;
+        else return (hi << (64 - F)) | (lo >> F);
+    }
+
+    // Divide (hi * 2^64 + lo) by 10, where hi < 10.
+    constexpr std::uint64_t divmod10(std::uint64_t hi, std::uint64_t lo, unsigned& rem) noexcept
+    {
+        const std::uint64_t a = (hi << 32) | (lo >> 32);
+        const std::uint64_t b = ((a % 10) << 32) | (lo & 0xffffffff);
+        rem = b % 10;
+        return ((a / 10) << 32) | (b / 10);
+    }
+
+    // Format the integer part, and the given fractional digits.  Rounding
+    // up has already been applied to the digits, and carry is set if it
+    // overflowed into the integer part.
+    inline std::to_chars_result write_fixed(char* first, char* last, const fixed_decimal& d, const char* digits, std::size_t n, bool carry)
+    {
+        char buf[24];
+        char* p = buf;
+        if (d.negative and (d.integer != 0 or carry or std::any_of(digits, digits + n, [](char c) { return c != '0'; })))
+            *p++ = '-';
+        p = std::to_chars(p, std::end(buf), d.integer + carry).ptr;
+        const std::size_t len = (p - buf) + (n > 0 ? n + 1 : 0);
+        if (static_cast<std::size_t>(last - first) < len) return { last, std::errc::value_too_large };
+        first = std::copy(buf, p, first);
+        if (n > 0)
+        {
+            *first++ = '.';
+            first = std::copy(digits, digits + n, first);
+        }
+        return { first, std::errc { } };
+    }
+
+    // Increment a string of decimal digits.  Returns true on overflow.
+    inline bool increment_digits(char* digits, std::size_t n) noexcept
+    {
+        while (n > 0)
+        {
+            if (digits[--n] != '9')
+            {
+                ++digits[n];
+                return false;
+            }
+            digits[n] = '0';
+        }
+        return true;
+    }
+}
+
+namespace jw
+{
+    // Write the shortest decimal representation that converts back to the
+    // same value via from_chars().
+    template<typename T, std::size_t F, fixed_overflow P>
+    std::to_chars_result to_chars(char* first, char* last, const fixed<T, F, P>& x)
+    {
+        const auto d = detail::split_fixed(x);
+        char digits[F + 1] { };
+        std::size_t n = 0;
+        std::uint64_t frac = d.fraction;
+        bool carry = false;
+
+        // After n digits, the remaining error is frac / (2^F * 10^n).  It
+        // must not exceed half a unit, ie. frac <= 10^n / 2.  Ties are
+        // resolved to even by from_chars().
+        std::uint64_t tolerance = 0;
+        const bool even = (x.value & 1) == 0;
+        auto acceptable = [&](std::uint64_t err) { return err < tolerance or (err == tolerance and even); };
+        while (frac != 0)
+        {
+            digits[n++] = '0' + detail::next_decimal_digit<F>(frac);
+            if (n == 1) tolerance = 5;
+            else if (__builtin_mul_overflow(tolerance, 10, &tolerance)) tolerance = ~std::uint64_t { 0 };
+            if (frac == 0) break;
+            const std::uint64_t up = (~frac & detail::fraction_mask<F>) + 1;
+            const bool down_ok = acceptable(frac);
+            const bool up_ok = acceptable(up);
+            if (up_ok and (not down_ok or up < frac))
+            {
+                carry = detail::increment_digits(digits, n);
+                break;
+            }
+            if (down_ok) break;
+        }
+        while (n > 0 and digits[n - 1] == '0') --n;
+        return detail::write_fixed(first, last, d, digits, n, carry);
+    }
+
+    // Write exactly the given number of decimal places, rounded to nearest,
+    // ties to even.
+    template<typename T, std::size_t F, fixed_overflow P>
+    std::to_chars_result to_chars(char* first, char* last, const fixed<T, F, P>& x, int precision)
+    {
+        const auto d = detail::split_fixed(x);
+        const std::size_t n = std::max(precision, 0);
+        char digits[F + 1] { };
+        std::uint64_t frac = d.fraction;
+        bool carry = false;
+        const std::size_t exact = std::min(n, F);
+        for (std::size_t i = 0; i < exact; ++i)
+            digits[i] = '0' + detail::next_decimal_digit<F>(frac);
+        if constexpr (F > 0)
+        {
+            constexpr std::uint64_t half = std::uint64_t { 1 } << (F - 1);
+            const bool odd = exact > 0 ? (digits[exact - 1] & 1) : (d.integer & 1);
+            if (frac > half or (frac == half and odd))
+                carry = detail::increment_digits(digits, exact);
+        }
+        if (n == exact) return detail::write_fixed(first, last, d, digits, n, carry);
+
+        // All digits beyond the F'th are zero.
+        const auto r = detail::write_fixed(first, last, d, digits, exact, carry);
+        if (r.ec != std::errc { }) return r;
+        const std::size_t zeros = n - exact + (exact == 0);
+        if (static_cast<std::size_t>(last - r.ptr) < zeros) return { last, std::errc::value_too_large };
+        char* p = r.ptr;
+        if (exact == 0) *p++ = '.';
+        return { std::fill_n(p, n - exact, '0'), std::errc { } };
+    }
+
+    // Parse a decimal number, rounded to the nearest representable value,
+    // ties to even.  As with std::from_chars, a leading '+' or whitespace
+    // is not accepted.  If the number is out of range, x is not modified,
+    // and std::errc::result_out_of_range is returned.
+    template<typename T, std::size_t F, fixed_overflow P>
+    std::from_chars_result from_chars(const char* first, const char* last, fixed<T, F, P>& x)
+    {
+        auto is_digit = [](char c) { return c >= '0' and c <= '9'; };
+        const char* p = first;
+        const bool negative = p != last and *p == '-';
+        if (negative)
+        {
+            if constexpr (std::is_unsigned_v<T>) return { first, std::errc::invalid_argument };
+            ++p;
+        }
+
+        bool overflow = false;
+        std::uint64_t integer = 0;
+        const char* const int_begin = p;
+        for (; p != last and is_digit(*p); ++p)
+        {
+            overflow |= __builtin_mul_overflow(integer, 10, &integer);
+            overflow |= __builtin_add_overflow(integer, *p - '0', &integer);
+        }
+        const char* const int_end = p;
+        const char* frac_begin = p;
+        if (p != last and *p == '.')
+        {
+            frac_begin = ++p;
+            while (p != last and is_digit(*p)) ++p;
+        }
+        const char* const frac_end = p;
+        if (int_begin == int_end and frac_begin == frac_end) return { first, std::errc::invalid_argument };
+
+        // Convert the fraction from the last digit to the first.  After
+        // each step, q = floor(2^F * 0.d[i]d[i+1]...).  The remainder of
+        // the final step, and whether any remainder was lost before that,
+        // determine the rounding.
+        std::uint64_t q = 0;
+        unsigned rem = 0;
+        bool sticky = false;
+        for (const char* i = frac_end; i != frac_begin; )
+        {
+            sticky |= rem != 0;
+            const std::uint64_t digit = *--i - '0';
+            std::uint64_t hi = 0, lo = 0;
+            if constexpr (F == 64) hi = digit;
+            else if constexpr (F > 0)
+            {
+                hi = digit >> (64 - F);
+                lo = digit << F;
+            }
+            else lo = digit;
+            q = detail::divmod10(hi, lo | q, rem);
+        }
+
+        std::uint64_t magnitude = q;
+        if constexpr (F < 64)
+        {
+            overflow |= integer > (~std::uint64_t { 0 } >> F);
+            magnitude |= integer << F;
+        }
+        else overflow |= integer != 0;
+        if (rem > 5 or (rem == 5 and (sticky or (magnitude & 1))))
+            overflow |= __builtin_add_overflow(magnitude, 1, &magnitude);
+
+        using limits = std::numeric_limits<T>;
+        const std::uint64_t max = negative ? 0 - static_cast<std::uint64_t>(static_cast<std::int64_t>(limits::min())) : limits::max();
+        if (overflow or magnitude > max) return { p, std::errc::result_out_of_range };
+        x = fixed<T, F, P>::make(static_cast<T>(negative ? 0 - magnitude : magnitude));
+        return { p, std::errc { } };
+    }
+}
+
+#ifdef __cpp_lib_format
+// Formats a fixed-point value in decimal.  The only supported format
+// specification is an optional precision, eg. "{:.2}".  Without it, the
+// shortest round-trip representation is used.
+template<typename T, std::size_t F, jw::fixed_overflow P, typename CharT>
+struct std::formatter<jw::fixed<T, F, P>, CharT>
+{
+    constexpr auto parse(std::basic_format_parse_context<CharT>& ctx)
+    {
+        auto i = ctx.begin();
+        if (i != ctx.end() and *i == '.')
+        {
+            precision = 0;
+            for (++i; i != ctx.end() and *i >= '0' and *i <= '9'; ++i)
+                precision = precision * 10 + (*i - '0');
+        }
+        if (i != ctx.end() and *i != '}') throw std::format_error { "invalid format specification for jw::fixed" };
+        return i;
+    }
+
+    template<typename Ctx>
+    auto format(const jw::fixed<T, F, P>& x, Ctx& ctx) const
+    {
+        char buf[96];
+        const auto r = precision < 0 ? jw::to_chars(buf, std::end(buf), x)
+                                     : jw::to_chars(buf, std::end(buf), x, std::min(precision, 64));
+        return std::copy(buf, r.ptr, ctx.out());
+    }
+
+private:
+    int precision { -1 };
+};
+#endif
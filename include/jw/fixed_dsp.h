@@ -0,0 +1,376 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <array>
+#include <bit>
+#include <span>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <jw/fixed.h>
+#include <jw/fixed_math.h>
+#include <jw/circular_queue.h>
+#include <jw/detail/simd.h>
+
+// Signal processing on fixed-point samples: FIR filters, biquad IIR
+// cascades, and FFT.  Supported for signed types of up to 32 bits.  Sums
+// of products are accumulated at full precision in the next larger type,
+// with wrap-around arithmetic.  The extra bits act as guard bits, and
+// since only the final sum must fit, intermediate overflow is harmless.
+// Results are rounded back via round_to(), under the overflow policy of
+// the sample type.  Block operations are compiled for several instruction
+// sets, like those in fixed_simd.h.
+
+namespace jw::detail
+{
+    template<typename Fx>
+    concept dsp_fixed = is_fixed<Fx> and std::is_signed_v<typename Fx::type> and sizeof(typename Fx::type) <= 4;
+
+    // Accumulator for products of A and B.
+    template<typename A, typename B>
+    using dsp_acc_t = fixed<larger_t<max_t<typename A::type, typename B::type>>, A::frac_bits + B::frac_bits, fixed_overflow::wrap>;
+
+    template<typename A, typename B>
+    constexpr dsp_acc_t<A, B> dsp_product(const A& a, const B& b) noexcept
+    {
+        return dsp_acc_t<A, B>::make((a * b).value);
+    }
+
+    // Sum of a[i] * b[i], for i in [0, n).
+    template<typename A, typename B>
+    constexpr dsp_acc_t<A, B> dsp_dot(const A* a, const B* b, std::size_t n) noexcept
+    {
+        dsp_acc_t<A, B> sum { };
+        for (std::size_t i = 0; i < n; ++i)
+            sum += dsp_product(a[i], b[i]);
+        return sum;
+    }
+}
+
+namespace jw
+{
+    template<typename Fx>
+    struct fixed_complex
+    {
+        Fx re, im;
+
+        friend constexpr bool operator==(const fixed_complex& a, const fixed_complex& b) noexcept { return a.re == b.re and a.im == b.im; }
+    };
+
+    // Finite impulse response filter with N taps.  The most recent input
+    // samples are kept in a static_circular_queue.  Each output is the
+    // convolution of the coefficients with the (at most two) contiguous
+    // parts of the queue.
+    template<typename Fx, std::size_t N, typename Coef = Fx> requires (detail::dsp_fixed<Fx> and detail::dsp_fixed<Coef> and N > 0)
+    struct fir_filter
+    {
+        using value_type = Fx;
+        using coefficient_type = Coef;
+
+        // Construct from coefficients h[0] .. h[N - 1], where h[0] applies to
+        // the most recent sample.
+        fir_filter(std::span<const Coef, N> h) noexcept
+        {
+            std::reverse_copy(h.begin(), h.end(), taps.begin());
+            reset();
+        }
+
+        fir_filter(const fir_filter&) = delete;
+        fir_filter& operator=(const fir_filter&) = delete;
+
+        // Clear the delay line.
+        void reset() noexcept
+        {
+            history.consumer()->clear();
+            history.producer()->try_append(N - 1, Fx { 0 });
+        }
+
+        // Filter a single sample.
+        Fx process(const Fx& x)
+        {
+            history.producer()->try_push_back(x);
+            const auto sum = convolve();
+            history.consumer()->pop_front();
+            return round_to<Fx>(sum);
+        }
+
+        // Filter a block of samples.  In-place operation is allowed.
+        void process(std::span<const Fx> in, std::span<Fx> out)
+        {
+            assert(in.size() == out.size());
+            detail::simd_dispatch([this, x = in.data(), y = out.data(), n = in.size()]
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    y[i] = process(x[i]);
+            });
+        }
+
+    private:
+        // Taps in reverse order, so they line up with the queue, which holds
+        // the oldest sample first.
+        std::array<Coef, N> taps;
+        static_circular_queue<Fx, std::bit_ceil(N + 1)> history;
+
+        auto convolve() const noexcept
+        {
+            const auto* q = history.consumer();
+            const auto i = q->cbegin();
+            const Fx* p = &*i;
+            const std::size_t n = q->contiguous_end(i) - p;
+            auto sum = detail::dsp_dot(p, taps.data(), n);
+            if (n < N) sum += detail::dsp_dot(&*(i + n), taps.data() + n, N - n);
+            return sum;
+        }
+    };
+
+    // Coefficients of one second-order section, normalized so that a0 = 1:
+    // y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+    template<typename Coef>
+    struct biquad_coefficients
+    {
+        Coef b0, b1, b2, a1, a2;
+    };
+
+    // Default coefficient type for biquad filters, with a range of [-4, 4).
+    template<typename Fx>
+    using biquad_coefficient_t = fixed<typename Fx::type, Fx::bits - 2, Fx::overflow_policy>;
+
+    // Cascade of biquad (second-order IIR) sections, in direct form I.  The
+    // output of each section is rounded to Fx before it is fed back.
+    template<typename Fx, std::size_t Sections, typename Coef = biquad_coefficient_t<Fx>>
+        requires (detail::dsp_fixed<Fx> and detail::dsp_fixed<Coef> and Sections > 0)
+    struct biquad_cascade
+    {
+        using value_type = Fx;
+        using coefficient_type = Coef;
+        using coefficients = biquad_coefficients<Coef>;
+
+        constexpr biquad_cascade(std::span<const coefficients, Sections> c) noexcept
+        {
+            std::copy(c.begin(), c.end(), coef.begin());
+            reset();
+        }
+
+        // Clear the filter state.
+        constexpr void reset() noexcept { state.fill({ }); }
+
+        // Filter a single sample.
+        constexpr Fx process(Fx x)
+        {
+            for (std::size_t s = 0; s < Sections; ++s)
+            {
+                const auto& c = coef[s];
+                auto& z = state[s];
+                const Fx y = round_to<Fx>(detail::dsp_product(x, c.b0) + detail::dsp_product(z.x1, c.b1) + detail::dsp_product(z.x2, c.b2)
+                                          - detail::dsp_product(z.y1, c.a1) - detail::dsp_product(z.y2, c.a2));
+                z.x2 = z.x1;
+                z.x1 = x;
+                z.y2 = z.y1;
+                z.y1 = y;
+                x = y;
+            }
+            return x;
+        }
+
+        // Filter a block of samples.  In-place operation is allowed.  The
+        // block is processed one section at a time, in chunks.  The
+        // feed-forward part of each section is computed for the entire chunk
+        // first, which vectorizes.  Only the feedback part is sequential.
+        void process(std::span<const Fx> in, std::span<Fx> out)
+        {
+            assert(in.size() == out.size());
+            detail::simd_dispatch([this, x = in.data(), y = out.data(), size = in.size()]
+            {
+                constexpr std::size_t chunk = 64;
+                acc_type w[chunk];
+                Fx buf[chunk + 2];      // Two samples of history, then the chunk.
+                for (std::size_t pos = 0; pos < size; pos += chunk)
+                {
+                    const std::size_t n = std::min(chunk, size - pos);
+                    std::copy_n(x + pos, n, buf + 2);
+                    for (std::size_t s = 0; s < Sections; ++s)
+                    {
+                        const auto& c = coef[s];
+                        auto& z = state[s];
+                        buf[0] = z.x2;
+                        buf[1] = z.x1;
+                        z.x2 = buf[n];
+                        z.x1 = buf[n + 1];
+
+                        for (std::size_t i = 0; i < n; ++i)
+                            w[i] = detail::dsp_product(buf[i + 2], c.b0) + detail::dsp_product(buf[i + 1], c.b1) + detail::dsp_product(buf[i], c.b2);
+
+                        Fx y1 = z.y1, y2 = z.y2;
+                        for (std::size_t i = 0; i < n; ++i)
+                        {
+                            const Fx y0 = round_to<Fx>(w[i] - detail::dsp_product(y1, c.a1) - detail::dsp_product(y2, c.a2));
+                            buf[i + 2] = y0;
+                            y2 = y1;
+                            y1 = y0;
+                        }
+                        z.y1 = y1;
+                        z.y2 = y2;
+                    }
+                    std::copy_n(buf + 2, n, y + pos);
+                }
+            });
+        }
+
+    private:
+        using acc_type = detail::dsp_acc_t<Fx, Coef>;
+
+        struct section_state
+        {
+            Fx x1, x2, y1, y2;
+        };
+
+        std::array<coefficients, Sections> coef;
+        std::array<section_state, Sections> state;
+    };
+
+    // Fast Fourier transform of N points, in place, with block
+    // floating-point scaling.  Before each pass, all values are shifted
+    // right as far as needed to rule out overflow.  The total shift is
+    // returned as a block exponent e, so that the exact transform of the
+    // input equals the output times 2^e.  Passes are radix-4 (two fused
+    // radix-2 stages), with one radix-2 pass if log2(N) is odd.
+    template<typename Fx, std::size_t N> requires (detail::dsp_fixed<Fx> and std::has_single_bit(N) and N >= 2)
+    struct fixed_fft
+    {
+        using value_type = fixed_complex<Fx>;
+
+        // Twiddle factors have no integer bits.  Only cos(0) = 1 is not
+        // representable, and saturates to 1 - 2^-F.
+        using twiddle_type = fixed<typename Fx::type, Fx::bits, fixed_overflow::saturate>;
+
+        // Forward transform: X[k] = sum(x[n] * e^(-2 pi i k n / N)).
+        static int forward(std::span<value_type, N> data) { return transform<false>(data.data()); }
+
+        // Inverse transform, without the 1/N factor (which may be applied
+        // by subtracting log2(N) from the exponent).
+        static int inverse(std::span<value_type, N> data) { return transform<true>(data.data()); }
+
+    private:
+        using T = typename Fx::type;
+        using acc_type = detail::dsp_acc_t<Fx, twiddle_type>;
+        static constexpr unsigned bits = Fx::bits;
+
+        // W[k] = e^(-2 pi i k / N), for k in [0, N / 2).
+        static constexpr auto twiddles = []() consteval
+        {
+            constexpr long double pi = 3.14159265358979323846264338327950288L;
+            std::array<fixed_complex<twiddle_type>, N / 2> w { };
+            for (std::size_t k = 0; k < N / 2; ++k)
+            {
+                const long double x = 2 * pi * k / N;
+                w[k] = { twiddle_type { detail::ct_sin(x + pi / 2) }, twiddle_type { -detail::ct_sin(x) } };
+            }
+            return w;
+        }();
+
+        // a * w, or a * conj(w) for the inverse transform.
+        template<bool Inverse>
+        static constexpr value_type multiply(const value_type& a, const fixed_complex<twiddle_type>& w)
+        {
+            using detail::dsp_product;
+            if constexpr (Inverse)
+                return { round_to<Fx>(dsp_product(a.re, w.re) + dsp_product(a.im, w.im)),
+                         round_to<Fx>(dsp_product(a.im, w.re) - dsp_product(a.re, w.im)) };
+            else
+                return { round_to<Fx>(dsp_product(a.re, w.re) - dsp_product(a.im, w.im)),
+                         round_to<Fx>(dsp_product(a.im, w.re) + dsp_product(a.re, w.im)) };
+        }
+
+        // Shift all values right, so that they fit in (bits - guard) bits.
+        // Returns the number of bits shifted.
+        static int rescale(value_type* x, unsigned guard) noexcept
+        {
+            using U = std::make_unsigned_t<T>;
+            U m = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                m |= static_cast<U>(x[i].re.value ^ (x[i].re.value >> bits)) | static_cast<U>(x[i].im.value ^ (x[i].im.value >> bits));
+            const int shift = std::bit_width(m) - static_cast<int>(bits - guard);
+            if (shift <= 0) return 0;
+            // Round to nearest, but not up to the limit.
+            const T max = (T { 1 } << (bits - guard)) - 1;
+            auto shr = [shift, max](T v) { return std::min<T>((v >> shift) + ((v >> (shift - 1)) & 1), max); };
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                x[i].re.value = shr(x[i].re.value);
+                x[i].im.value = shr(x[i].im.value);
+            }
+            return shift;
+        }
+
+        static void bit_reverse(value_type* x) noexcept
+        {
+            for (std::size_t i = 1, j = 0; i < N; ++i)
+            {
+                std::size_t bit = N >> 1;
+                for (; j & bit; bit >>= 1) j ^= bit;
+                j ^= bit;
+                if (i < j) std::swap(x[i], x[j]);
+            }
+        }
+
+        template<bool Inverse>
+        static int transform(value_type* x)
+        {
+            int exponent = 0;
+            detail::simd_dispatch([x, &exponent]
+            {
+                bit_reverse(x);
+                std::size_t m = 1;
+
+                // Radix-2 pass.  Values grow by at most a factor 2.
+                if (std::countr_zero(N) & 1)
+                {
+                    exponent += rescale(x, 1);
+                    for (std::size_t i = 0; i < N; i += 2)
+                    {
+                        const value_type a = x[i], b = x[i + 1];
+                        x[i] = { a.re + b.re, a.im + b.im };
+                        x[i + 1] = { a.re - b.re, a.im - b.im };
+                    }
+                    m = 2;
+                }
+
+                // Radix-4 passes, combining the radix-2 stages with half-size
+                // m and 2m.  Components grow by at most (1 + sqrt(2))^2 < 8.
+                for (; m < N; m *= 4)
+                {
+                    exponent += rescale(x, 3);
+                    for (std::size_t j = 0; j < N; j += 4 * m)
+                    {
+                        for (std::size_t k = 0; k < m; ++k)
+                        {
+                            const auto& w1 = twiddles[k * (N / (2 * m))];
+                            const auto& w2 = twiddles[k * (N / (4 * m))];
+                            value_type* p = x + j + k;
+                            const value_type a = p[0], c = p[2 * m];
+                            const value_type b = multiply<Inverse>(p[m], w1);
+                            const value_type d = multiply<Inverse>(p[3 * m], w1);
+                            const value_type a1 { a.re + b.re, a.im + b.im }, b1 { a.re - b.re, a.im - b.im };
+                            const value_type c1 { c.re + d.re, c.im + d.im }, d1 { c.re - d.re, c.im - d.im };
+                            const value_type tc = multiply<Inverse>(c1, w2);
+                            const value_type u = multiply<Inverse>(d1, w2);
+
+                            // td = -i * u, or i * u for the inverse.  Values are
+                            // small enough that negation can't overflow.
+                            auto neg = [](const Fx& v) { return Fx::make(-v.value); };
+                            const value_type td = Inverse ? value_type { neg(u.im), u.re } : value_type { u.im, neg(u.re) };
+                            p[0]     = { a1.re + tc.re, a1.im + tc.im };
+                            p[2 * m] = { a1.re - tc.re, a1.im - tc.im };
+                            p[m]     = { b1.re + td.re, b1.im + td.im };
+                            p[3 * m] = { b1.re - td.re, b1.im - td.im };
+                        }
+                    }
+                }
+            });
+            return exponent;
+        }
+    };
+}
@@ -0,0 +1,310 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <jw/fixed.h>
+
+// Mathematical functions on fixed-point values, implemented entirely in
+// integer arithmetic.  Supported for types of up to 32 bits.  Results are
+// rounded to nearest, and subject to the overflow policy of the argument
+// type.  Error bounds are given in units of the last place (ULP) of the
+// result, or as absolute/relative error for table-based functions.  These
+// hold for any F, as long as the result is representable.
+
+namespace jw::detail
+{
+    // Functions used to generate lookup tables at compile time.
+    consteval long double ct_sqrt(long double x)
+    {
+        long double r = x > 1 ? x : 1;
+        for (int i = 0; i < 64; ++i) r = (r + x / r) / 2;
+        return r;
+    }
+
+    consteval long double ct_sin(long double x)
+    {
+        long double sum = 0, term = x;
+        for (int n = 1; n < 40; n += 2)
+        {
+            sum += term;
+            term *= -x * x / ((n + 1) * (n + 2));
+        }
+        return sum;
+    }
+
+    consteval long double ct_atan(long double x)
+    {
+        // atan(x) = 2 * atan(x / (1 + sqrt(1 + x^2))), applied twice.
+        for (int i = 0; i < 2; ++i) x /= 1 + ct_sqrt(1 + x * x);
+        long double sum = 0, term = x;
+        for (int n = 1; n < 60; n += 2)
+        {
+            sum += term / n;
+            term *= -x * x;
+        }
+        return 4 * sum;
+    }
+
+    consteval long double ct_exp2(long double x)
+    {
+        const long double y = x * 0.693147180559945309417232121458176568L;
+        long double sum = 0, term = 1;
+        for (int n = 1; n < 40; ++n)
+        {
+            sum += term;
+            term *= y / n;
+        }
+        return sum;
+    }
+
+    consteval long double ct_log2(long double x)
+    {
+        // ln(x) = 2 * atanh((x - 1) / (x + 1))
+        const long double z = (x - 1) / (x + 1);
+        long double sum = 0, term = z;
+        for (int n = 1; n < 80; n += 2)
+        {
+            sum += term / n;
+            term *= z * z;
+        }
+        return 2 * sum / 0.693147180559945309417232121458176568L;
+    }
+
+    // Table of N + 1 values of func over [0, 1], in Q30 format.
+    template<std::size_t N, typename F>
+    consteval std::array<std::int32_t, N + 1> make_q30_table(F func)
+    {
+        std::array<std::int32_t, N + 1> table { };
+        for (std::size_t i = 0; i <= N; ++i)
+        {
+            const long double y = func(static_cast<long double>(i) / N) * (1L << 30);
+            table[i] = static_cast<std::int32_t>(y + 0.5L);
+        }
+        return table;
+    }
+
+    // sin(x * pi/2)
+    inline constexpr auto sin_table = make_q30_table<256>([](long double x) consteval { return ct_sin(x * 1.57079632679489661923132169163975144L); });
+
+    // atan(x)
+    inline constexpr auto atan_table = make_q30_table<256>([](long double x) consteval { return ct_atan(x); });
+
+    // 2^x - 1
+    inline constexpr auto exp2_table = make_q30_table<256>([](long double x) consteval { return ct_exp2(x) - 1; });
+
+    // log2(1 + x)
+    inline constexpr auto log2_table = make_q30_table<256>([](long double x) consteval { return ct_log2(1 + x); });
+
+    inline constexpr std::int64_t pi_q30 = 3373259426;
+    inline constexpr std::int64_t half_pi_q30 = 1686629713;
+
+    // round(2^64 / (2 * pi))
+    inline constexpr std::uint64_t turns_per_radian_q64 = 2935890503282001226;
+
+    // Linear interpolation in a table of 257 entries, at position x, which
+    // has 30 fractional bits.  Returns a Q30 value.
+    constexpr std::int32_t interpolate_q30(const std::array<std::int32_t, 257>& table, std::uint32_t x) noexcept
+    {
+        assume(x < (1u << 30));
+        const std::uint32_t i = x >> 22;
+        const std::int64_t f = x & ((1u << 22) - 1);
+        const std::int64_t d = table[i + 1] - table[i];
+        return table[i] + static_cast<std::int32_t>((d * f + (1 << 21)) >> 22);
+    }
+
+    // Integer square root, rounded to nearest.
+    constexpr std::uint64_t isqrt(std::uint64_t v) noexcept
+    {
+        if (v == 0) return 0;
+        std::uint64_t r = 0;
+        std::uint64_t bit = std::uint64_t { 1 } << ((std::bit_width(v) - 1) & ~1);
+        while (bit != 0)
+        {
+            if (v >= r + bit)
+            {
+                v -= r + bit;
+                r = (r >> 1) + bit;
+            }
+            else r >>= 1;
+            bit >>= 2;
+        }
+        if (v > r) ++r;
+        return r;
+    }
+
+    // Returns floor(2^e / v).  The result must fit in 64 bits.
+    constexpr std::uint64_t div_pow2(unsigned e, std::uint32_t v) noexcept
+    {
+        std::uint64_t q = 0, rem = 0;
+        for (int k = e / 32; k >= 0; --k)
+        {
+            const std::uint64_t digit = k == static_cast<int>(e / 32) ? std::uint64_t { 1 } << (e % 32) : 0;
+            const std::uint64_t cur = (rem << 32) | digit;
+            q = (q << 32) | (cur / v);
+            rem = cur % v;
+        }
+        return q;
+    }
+
+    // Convert an angle in radians, with F fractional bits, to a binary
+    // angle, where 2^32 is one full turn.  This reduces the angle to a
+    // single period for free.  The 128-bit product with a Q64 constant
+    // keeps the error below 2^-32 turn for any 32-bit input.
+    template<std::size_t F, std::integral T>
+    constexpr std::uint32_t radians_to_turns(T v) noexcept
+    {
+        static_assert(F <= 32);
+        constexpr unsigned shift = F + 32;
+        const auto x = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+        std::uint64_t hi = mulhi(x, turns_per_radian_q64) - (v < 0 ? turns_per_radian_q64 : 0);
+        std::uint64_t lo = x * turns_per_radian_q64;
+        const std::uint64_t round = std::uint64_t { 1 } << (shift - 1);
+        lo += round;
+        hi += lo < round;
+        if constexpr (shift == 64) return static_cast<std::uint32_t>(hi);
+        else return static_cast<std::uint32_t>((hi << (64 - shift)) | (lo >> shift));
+    }
+
+    // sin() of a binary angle, in Q30.
+    constexpr std::int32_t sin_q30(std::uint32_t turns) noexcept
+    {
+        const std::uint32_t quadrant = turns >> 30;
+        std::uint32_t x = turns & 0x3fffffff;
+        if (quadrant & 1) x = ~x & 0x3fffffff;
+        const std::int32_t s = interpolate_q30(sin_table, x);
+        return (quadrant & 2) ? -s : s;
+    }
+
+    // atan2() in Q30.
+    constexpr std::int64_t atan2_q30(std::int64_t y, std::int64_t x) noexcept
+    {
+        const std::uint64_t ax = x < 0 ? -x : x;
+        const std::uint64_t ay = y < 0 ? -y : y;
+        if (ax == 0 and ay == 0) return 0;
+        const bool swap = ay > ax;
+        const std::uint64_t num = swap ? ax : ay;
+        const std::uint64_t den = swap ? ay : ax;
+        const auto r = static_cast<std::uint32_t>(std::min<std::uint64_t>((num << 30) / den, 0x3fffffff));
+        std::int64_t a = interpolate_q30(atan_table, r);
+        if (swap) a = half_pi_q30 - a;
+        if (x < 0) a = pi_q30 - a;
+        return y < 0 ? -a : a;
+    }
+
+    // log2() of a positive value with F fractional bits, in Q30.
+    template<std::size_t F, std::integral T>
+    constexpr std::int64_t log2_q30(T v) noexcept
+    {
+        const auto u = static_cast<std::uint32_t>(v);
+        const int msb = std::bit_width(u) - 1;
+        const std::uint32_t m = shl(u, 30 - msb) & 0x3fffffff;
+        return (static_cast<std::int64_t>(msb - static_cast<int>(F)) << 30) + interpolate_q30(log2_table, m);
+    }
+
+    // 2^x, where x has A fractional bits, converted to fixed<T, F, P>.
+    template<typename T, std::size_t F, fixed_overflow P>
+    constexpr T exp2_raw(std::int64_t x, unsigned A)
+    {
+        const std::int64_t n = x >> A;
+        const auto frac = static_cast<std::uint64_t>(x) & ((std::uint64_t { 1 } << A) - 1);
+        const auto f = static_cast<std::uint32_t>(shl(frac, 30 - static_cast<int>(A)));
+        const std::int64_t m = (std::int64_t { 1 } << 30) + interpolate_q30(exp2_table, f);
+        const std::int64_t shift = n + static_cast<std::int64_t>(F) - 30;
+        if (shift > 32) return fixed_overflowed<P, T>(true);
+        if (shift >= 0) return fixed_narrow<P, T>(m << shift);
+        if (shift < -32) return 0;
+        return fixed_narrow<P, T>((m + (std::int64_t { 1 } << (-shift - 1))) >> -shift);
+    }
+
+    template<typename T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> from_q30(std::int64_t v)
+    {
+        return round_to<fixed<T, F, P>>(fixed<std::int64_t, 30>::make(v));
+    }
+
+    template<typename T>
+    concept fixed_math_type = sizeof(T) <= 4;
+}
+
+namespace jw
+{
+    // Square root.  Exact (error <= 0.5 ULP).  x must not be negative.
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> sqrt(const fixed<T, F, P>& x)
+    {
+        assert(std::cmp_greater_equal(x.value, 0));
+        const std::uint64_t v = static_cast<std::uint64_t>(x.value) << F;
+        return fixed<T, F, P>::make(detail::fixed_narrow<P, T>(detail::isqrt(v)));
+    }
+
+    // Reciprocal square root.  Error <= 0.5 ULP + 2^-32 relative.  x must
+    // be positive.
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> rsqrt(const fixed<T, F, P>& x)
+    {
+        assert(std::cmp_greater(x.value, 0));
+        const auto v = static_cast<std::uint32_t>(x.value);
+        if constexpr (3 * F >= 64)
+            if (v <= std::uint64_t { 1 } << (3 * F - 64))
+                return fixed<T, F, P>::make(detail::fixed_overflowed<P, T>(true));
+        const std::uint64_t q = detail::div_pow2(3 * F, v);
+        return fixed<T, F, P>::make(detail::fixed_narrow<P, T>(detail::isqrt(q)));
+    }
+
+    // Sine of an angle in radians.  Absolute error < 2^-17, plus rounding
+    // of the result (<= 0.5 ULP).
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> sin(const fixed<T, F, P>& x)
+    {
+        return detail::from_q30<T, F, P>(detail::sin_q30(detail::radians_to_turns<F>(x.value)));
+    }
+
+    // Cosine of an angle in radians.  Error bounds as for sin().
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> cos(const fixed<T, F, P>& x)
+    {
+        return detail::from_q30<T, F, P>(detail::sin_q30(detail::radians_to_turns<F>(x.value) + (1u << 30)));
+    }
+
+    // Angle of the vector (x, y) in radians, in the range [-pi, pi].
+    // Absolute error < 2^-19, plus rounding of the result (<= 0.5 ULP).
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> atan2(const fixed<T, F, P>& y, const fixed<T, F, P>& x)
+    {
+        return detail::from_q30<T, F, P>(detail::atan2_q30(y.value, x.value));
+    }
+
+    // Base-2 exponential.  Relative error < 2^-19, plus rounding of the
+    // result (<= 0.5 ULP).
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> exp2(const fixed<T, F, P>& x)
+    {
+        return fixed<T, F, P>::make(detail::exp2_raw<T, F, P>(x.value, F));
+    }
+
+    // Base-2 logarithm.  Absolute error < 2^-18, plus rounding of the
+    // result (<= 0.5 ULP).  x must be positive.
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P>
+    constexpr fixed<T, F, P> log2(const fixed<T, F, P>& x)
+    {
+        assert(std::cmp_greater(x.value, 0));
+        return detail::from_q30<T, F, P>(detail::log2_q30<F>(x.value));
+    }
+
+    // x raised to the power y, computed as exp2(y * log2(x)).  Relative
+    // error < 2^-19 + |y| * 2^-18, plus rounding of the result.  x must be
+    // positive.
+    template<detail::fixed_math_type T, std::size_t F, fixed_overflow P, detail::fixed_math_type U, std::size_t G, fixed_overflow Q>
+    constexpr fixed<T, F, P> pow(const fixed<T, F, P>& x, const fixed<U, G, Q>& y)
+    {
+        assert(std::cmp_greater(x.value, 0));
+        const std::int64_t l = detail::log2_q30<F>(x.value) >> 6;
+        return fixed<T, F, P>::make(detail::exp2_raw<T, F, P>(l * y.value, 24 + G));
+    }
+}
@@ -0,0 +1,197 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <compare>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <jw/fixed.h>
+
+// Selection of fixed-point formats from value ranges, at compile time.
+
+namespace jw::detail
+{
+    // Smallest integer type with at least N value bits.
+    template<bool Signed, std::size_t N>
+    using range_int_t = std::conditional_t<Signed,
+        std::conditional_t<(N <= 7), std::int8_t, std::conditional_t<(N <= 15), std::int16_t, std::conditional_t<(N <= 31), std::int32_t, std::int64_t>>>,
+        std::conditional_t<(N <= 8), std::uint8_t, std::conditional_t<(N <= 16), std::uint16_t, std::conditional_t<(N <= 32), std::uint32_t, std::uint64_t>>>>;
+
+    // Smallest number of fractional bits for the given resolution.
+    consteval std::size_t range_frac_bits(double resolution)
+    {
+        std::size_t f = 0;
+        for (double step = 1; step > resolution; step /= 2) ++f;
+        return f;
+    }
+
+    // Smallest number of integer bits that holds [min, max], with F
+    // fractional bits.  The largest value is limit - ulp, which may not be
+    // representable as double, so compare the difference instead.
+    consteval std::size_t range_int_bits(double min, double max, std::size_t f)
+    {
+        double ulp = 1;
+        for (std::size_t i = 0; i < f; ++i) ulp /= 2;
+        std::size_t i = 0;
+        for (double limit = 1; limit - max < ulp or min < -limit; limit *= 2) ++i;
+        return i;
+    }
+
+    template<double Min, double Max, double Resolution>
+    struct fixed_range
+    {
+        static_assert(Min <= Max);
+        static_assert(Resolution > 0);
+
+        static constexpr bool is_signed = Min < 0;
+        static constexpr std::size_t min_frac_bits = range_frac_bits(Resolution);
+        static constexpr std::size_t int_bits = range_int_bits(Min, Max, min_frac_bits);
+        static_assert(int_bits + min_frac_bits <= (is_signed ? 63 : 64), "range and resolution don't fit in 64 bits");
+
+        using int_type = range_int_t<is_signed, int_bits + min_frac_bits>;
+        using type = fixed<int_type, std::numeric_limits<int_type>::digits - int_bits>;
+    };
+
+    // Convert fixed type Fx to a signed type, if S is true.  An unsigned
+    // type is widened, so that all values remain representable.
+    template<typename Fx, bool S>
+    using range_operand_t = std::conditional_t<S and std::is_unsigned_v<typename Fx::type>,
+                                               fixed<std::make_signed_t<wider_t<typename Fx::type>>, Fx::frac_bits>, Fx>;
+
+    template<typename T>
+    inline constexpr bool is_ranged_fixed = false;
+}
+
+namespace jw
+{
+    // The fixed type with the smallest integer type that holds all values
+    // in [Min, Max] at the given resolution.  All remaining bits are used
+    // for the fraction.  The result is unsigned if Min >= 0.
+    template<double Min, double Max, double Resolution>
+    using fixed_for_range = typename detail::fixed_range<Min, Max, Resolution>::type;
+
+    // Fixed-point value with a known range.  Sums, differences and products
+    // get a new range, and are stored in the smallest type for that range.
+    // The resolution of a result is the finest of both operands.  Results
+    // are computed exactly, then rounded.  Since the range is known,
+    // overflow can't occur.
+    template<double Min, double Max, double Resolution>
+    struct ranged_fixed
+    {
+        using fixed_type = fixed_for_range<Min, Max, Resolution>;
+        static constexpr double min = Min;
+        static constexpr double max = Max;
+        static constexpr double resolution = Resolution;
+
+        fixed_type value;
+
+        constexpr ranged_fixed() noexcept = default;
+
+        // Construct from any value that fixed_type can be constructed from.
+        // The value must lie within [Min, Max].
+        template<typename U> requires (std::constructible_from<fixed_type, U> and not detail::is_ranged_fixed<U>)
+        constexpr ranged_fixed(U v) : value { v }
+        {
+            assert(value >= fixed_type { Min } and value <= fixed_type { Max });
+        }
+
+        // Convert from a range that lies within this one.
+        template<double Min2, double Max2, double Res2> requires (Min2 >= Min and Max2 <= Max)
+        constexpr ranged_fixed(const ranged_fixed<Min2, Max2, Res2>& v) : value { round_to<fixed_type>(v.value) } { }
+
+        static constexpr ranged_fixed make(const fixed_type& v) noexcept { return ranged_fixed { noassert, v }; }
+
+        constexpr operator fixed_type() const noexcept { return value; }
+        template<std::floating_point U> constexpr operator U() const noexcept { return static_cast<U>(value); }
+
+    private:
+        struct noassert_t { } constexpr inline static noassert { };
+        constexpr ranged_fixed(noassert_t, const fixed_type& v) noexcept : value { v } { }
+    };
+}
+
+namespace jw::detail
+{
+    template<double Min, double Max, double Resolution>
+    inline constexpr bool is_ranged_fixed<ranged_fixed<Min, Max, Resolution>> = true;
+
+    // Sum or difference of a and b, computed exactly in the smallest type
+    // that holds the operands and the result, then rounded to R.  This
+    // may need more than 64 bits, when the operands have different
+    // resolutions.
+    template<typename R, typename A, typename B, typename Op>
+    constexpr R ranged_sum(const A& a, const B& b, Op op) noexcept
+    {
+        using Fa = typename A::fixed_type;
+        using Fb = typename B::fixed_type;
+        using Fr = typename R::fixed_type;
+        constexpr bool s = std::is_signed_v<typename Fa::type> or std::is_signed_v<typename Fb::type> or std::is_signed_v<typename Fr::type>;
+        constexpr std::size_t F = std::max(Fa::frac_bits, Fb::frac_bits);
+        constexpr std::size_t I = std::max({ Fa::int_bits, Fb::int_bits, Fr::int_bits });
+        using N = std::conditional_t<(I + F <= (s ? 63 : 64)), range_int_t<s, I + F>, larger_t<range_int_t<s, 64>>>;
+        static_assert(I + F <= static_cast<std::size_t>(std::numeric_limits<N>::digits), "exact sum does not fit in the widest integer type");
+        using W = fixed<N, F>;
+        return R::make(round_to<Fr>(op(W { a.value }, W { b.value })));
+    }
+}
+
+namespace jw
+{
+    template<double A0, double A1, double Ar, double B0, double B1, double Br>
+    constexpr auto operator+(const ranged_fixed<A0, A1, Ar>& a, const ranged_fixed<B0, B1, Br>& b) noexcept
+    {
+        using R = ranged_fixed<A0 + B0, A1 + B1, std::min(Ar, Br)>;
+        return detail::ranged_sum<R>(a, b, std::plus<> { });
+    }
+
+    template<double A0, double A1, double Ar, double B0, double B1, double Br>
+    constexpr auto operator-(const ranged_fixed<A0, A1, Ar>& a, const ranged_fixed<B0, B1, Br>& b) noexcept
+    {
+        using R = ranged_fixed<A0 - B1, A1 - B0, std::min(Ar, Br)>;
+        return detail::ranged_sum<R>(a, b, std::minus<> { });
+    }
+
+    // The product is computed at full precision, as with fixed, and
+    // rounded to the type for the product range.
+    template<double A0, double A1, double Ar, double B0, double B1, double Br>
+    constexpr auto operator*(const ranged_fixed<A0, A1, Ar>& a, const ranged_fixed<B0, B1, Br>& b) noexcept
+    {
+        using R = ranged_fixed<std::min({ A0 * B0, A0 * B1, A1 * B0, A1 * B1 }),
+                               std::max({ A0 * B0, A0 * B1, A1 * B0, A1 * B1 }), std::min(Ar, Br)>;
+        using Fa = typename ranged_fixed<A0, A1, Ar>::fixed_type;
+        using Fb = typename ranged_fixed<B0, B1, Br>::fixed_type;
+        constexpr bool s = std::is_signed_v<typename Fa::type> or std::is_signed_v<typename Fb::type>;
+        using Sa = detail::range_operand_t<Fa, s>;
+        using Sb = detail::range_operand_t<Fb, s>;
+        return R::make(round_to<typename R::fixed_type>(Sa { a.value } * Sb { b.value }));
+    }
+
+    // Comparisons convert both operands to signed, if either one is, since
+    // fixed_for_range gives an unsigned type for non-negative ranges.
+    template<double A0, double A1, double Ar, double B0, double B1, double Br>
+    constexpr bool operator==(const ranged_fixed<A0, A1, Ar>& a, const ranged_fixed<B0, B1, Br>& b) noexcept
+    {
+        using Fa = typename ranged_fixed<A0, A1, Ar>::fixed_type;
+        using Fb = typename ranged_fixed<B0, B1, Br>::fixed_type;
+        constexpr bool s = std::is_signed_v<typename Fa::type> or std::is_signed_v<typename Fb::type>;
+        return detail::range_operand_t<Fa, s> { a.value } == detail::range_operand_t<Fb, s> { b.value };
+    }
+
+    template<double A0, double A1, double Ar, double B0, double B1, double Br>
+    constexpr std::strong_ordering operator<=>(const ranged_fixed<A0, A1, Ar>& a, const ranged_fixed<B0, B1, Br>& b) noexcept
+    {
+        using Fa = typename ranged_fixed<A0, A1, Ar>::fixed_type;
+        using Fb = typename ranged_fixed<B0, B1, Br>::fixed_type;
+        constexpr bool s = std::is_signed_v<typename Fa::type> or std::is_signed_v<typename Fb::type>;
+        const detail::range_operand_t<Fa, s> x { a.value };
+        const detail::range_operand_t<Fb, s> y { b.value };
+        if (x < y) return std::strong_ordering::less;
+        if (y < x) return std::strong_ordering::greater;
+        return std::strong_ordering::equal;
+    }
+}
@@ -0,0 +1,176 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <span>
+#include <cassert>
+#include <concepts>
+#include <type_traits>
+#include <jw/fixed.h>
+#include <jw/fixed_math.h>
+#include <jw/detail/simd.h>
+
+// Bulk arithmetic on spans of fixed-point values.  Each operation is
+// written as a plain loop, which is compiled for several instruction sets
+// and selected at runtime.  Since all variants are generated from the
+// same code, they produce bit-identical results.  Source and destination
+// spans must have equal sizes.  Results are converted to the destination
+// type via round_to().
+
+namespace jw
+{
+    template<typename T>
+    concept fixed_type = is_fixed<std::remove_const_t<T>>;
+}
+
+namespace jw::detail
+{
+    // dst[i] = func(a[i])
+    template<typename D, typename A, typename F>
+    void fixed_transform(std::span<D> dst, std::span<A> a, F func)
+    {
+        assert(a.size() == dst.size());
+        simd_dispatch([d = dst.data(), x = a.data(), n = dst.size(), func]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = round_to<D>(func(x[i]));
+        });
+    }
+}
+
+namespace jw
+{
+    // dst[i] = a[i] + b[i]
+    template<fixed_type D, fixed_type A, fixed_type B>
+    void add(std::span<D> dst, std::span<A> a, std::span<B> b)
+    {
+        assert(a.size() == dst.size() and b.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), x = a.data(), y = b.data(), n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = round_to<D>(x[i] + y[i]);
+        });
+    }
+
+    // dst[i] = a[i] - b[i]
+    template<fixed_type D, fixed_type A, fixed_type B>
+    void subtract(std::span<D> dst, std::span<A> a, std::span<B> b)
+    {
+        assert(a.size() == dst.size() and b.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), x = a.data(), y = b.data(), n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = round_to<D>(x[i] - y[i]);
+        });
+    }
+
+    // dst[i] = a[i] * b[i]
+    template<fixed_type D, fixed_type A, fixed_type B>
+    void multiply(std::span<D> dst, std::span<A> a, std::span<B> b)
+    {
+        assert(a.size() == dst.size() and b.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), x = a.data(), y = b.data(), n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = round_to<D>(x[i] * y[i]);
+        });
+    }
+
+    // acc[i] += a[i] * b[i]
+    template<fixed_type D, fixed_type A, fixed_type B>
+    void multiply_accumulate(std::span<D> acc, std::span<A> a, std::span<B> b)
+    {
+        assert(a.size() == acc.size() and b.size() == acc.size());
+        detail::simd_dispatch([d = acc.data(), x = a.data(), y = b.data(), n = acc.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] += round_to<D>(x[i] * y[i]);
+        });
+    }
+
+    // dst[i] = a[i] * s
+    template<fixed_type D, fixed_type A, typename U, std::size_t G, fixed_overflow Q>
+    void scale(std::span<D> dst, std::span<A> a, fixed<U, G, Q> s)
+    {
+        assert(a.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), x = a.data(), s, n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = round_to<D>(x[i] * s);
+        });
+    }
+
+    // Returns the sum of a[i] * b[i].  Products are accumulated at full
+    // precision, in the type of the product by default.
+    template<typename Acc = void, fixed_type A, fixed_type B>
+    auto dot(std::span<A> a, std::span<B> b)
+    {
+        using R = std::conditional_t<std::is_void_v<Acc>, decltype(a[0] * b[0]), Acc>;
+        assert(a.size() == b.size());
+        R sum { 0 };
+        detail::simd_dispatch([&sum, x = a.data(), y = b.data(), n = a.size()]
+        {
+            R s { 0 };
+            for (std::size_t i = 0; i < n; ++i)
+                s += round_to<R>(x[i] * y[i]);
+            sum = s;
+        });
+        return sum;
+    }
+
+    // dst[i] = static_cast<U>(a[i])
+    template<std::floating_point U, fixed_type A>
+    void convert(std::span<U> dst, std::span<A> a)
+    {
+        assert(a.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), x = a.data(), n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = static_cast<U>(x[i]);
+        });
+    }
+
+    // dst[i] = D { a[i] }
+    template<fixed_type D, typename U> requires (std::floating_point<std::remove_const_t<U>>)
+    void convert(std::span<D> dst, std::span<U> a)
+    {
+        assert(a.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), x = a.data(), n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = D { x[i] };
+        });
+    }
+
+    // Element-wise versions of the functions in fixed_math.h.
+
+    template<fixed_type D, fixed_type A>
+    void sqrt(std::span<D> dst, std::span<A> a) { detail::fixed_transform(dst, a, [](auto x) { return sqrt(x); }); }
+
+    template<fixed_type D, fixed_type A>
+    void rsqrt(std::span<D> dst, std::span<A> a) { detail::fixed_transform(dst, a, [](auto x) { return rsqrt(x); }); }
+
+    template<fixed_type D, fixed_type A>
+    void sin(std::span<D> dst, std::span<A> a) { detail::fixed_transform(dst, a, [](auto x) { return sin(x); }); }
+
+    template<fixed_type D, fixed_type A>
+    void cos(std::span<D> dst, std::span<A> a) { detail::fixed_transform(dst, a, [](auto x) { return cos(x); }); }
+
+    template<fixed_type D, fixed_type A>
+    void exp2(std::span<D> dst, std::span<A> a) { detail::fixed_transform(dst, a, [](auto x) { return exp2(x); }); }
+
+    template<fixed_type D, fixed_type A>
+    void log2(std::span<D> dst, std::span<A> a) { detail::fixed_transform(dst, a, [](auto x) { return log2(x); }); }
+
+    // dst[i] = atan2(y[i], x[i])
+    template<fixed_type D, fixed_type A, fixed_type B>
+    void atan2(std::span<D> dst, std::span<A> y, std::span<B> x)
+    {
+        assert(y.size() == dst.size() and x.size() == dst.size());
+        detail::simd_dispatch([d = dst.data(), p = y.data(), q = x.data(), n = dst.size()]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = round_to<D>(atan2(p[i], q[i]));
+        });
+    }
+}
@@ -0,0 +1,182 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <jw/fixed.h>
+
+// Small vectors and matrices of fixed-point values.  All operations are
+// plain loops over the components, which the compiler turns into SIMD
+// instructions where possible.  Element-wise arithmetic follows the
+// overflow policy of the element type.  Dot products, cross products and
+// matrix products are accumulated at full precision, and rounded back via
+// round_to().
+
+namespace jw::detail
+{
+    // Vectors are padded to a power-of-two size, so that they can be
+    // loaded into a single register.
+    template<typename Fx, std::size_t N>
+    inline constexpr std::size_t fixed_vec_align = std::min<std::size_t>(std::bit_ceil(N * sizeof(Fx)), 64);
+
+    template<typename Fx>
+    using fixed_product_t = decltype(std::declval<Fx>() * std::declval<Fx>());
+}
+
+namespace jw
+{
+    template<typename Fx, std::size_t N> requires (is_fixed<Fx> and N > 0)
+    struct alignas(detail::fixed_vec_align<Fx, N>) fixed_vec
+    {
+        using value_type = Fx;
+
+        Fx v[N];
+
+        static constexpr std::size_t size() noexcept { return N; }
+
+        // Returns a vector with all components set to x.
+        static constexpr fixed_vec broadcast(const Fx& x) noexcept
+        {
+            fixed_vec r;
+            for (auto& c : r.v) c = x;
+            return r;
+        }
+
+        constexpr Fx& operator[](std::size_t i) noexcept { return v[i]; }
+        constexpr const Fx& operator[](std::size_t i) const noexcept { return v[i]; }
+
+        constexpr Fx* begin() noexcept { return v; }
+        constexpr Fx* end() noexcept { return v + N; }
+        constexpr const Fx* begin() const noexcept { return v; }
+        constexpr const Fx* end() const noexcept { return v + N; }
+
+        constexpr fixed_vec& operator+=(const fixed_vec& o) { for (std::size_t i = 0; i < N; ++i) v[i] += o.v[i]; return *this; }
+        constexpr fixed_vec& operator-=(const fixed_vec& o) { for (std::size_t i = 0; i < N; ++i) v[i] -= o.v[i]; return *this; }
+        constexpr fixed_vec& operator*=(const fixed_vec& o) { for (std::size_t i = 0; i < N; ++i) v[i] *= o.v[i]; return *this; }
+        constexpr fixed_vec& operator/=(const fixed_vec& o) { for (std::size_t i = 0; i < N; ++i) v[i] /= o.v[i]; return *this; }
+
+        constexpr fixed_vec& operator*=(const Fx& s) { for (auto& c : v) c *= s; return *this; }
+        constexpr fixed_vec& operator/=(const Fx& s) { for (auto& c : v) c /= s; return *this; }
+
+        friend constexpr fixed_vec operator+(fixed_vec a, const fixed_vec& b) { return a += b; }
+        friend constexpr fixed_vec operator-(fixed_vec a, const fixed_vec& b) { return a -= b; }
+        friend constexpr fixed_vec operator*(fixed_vec a, const fixed_vec& b) { return a *= b; }
+        friend constexpr fixed_vec operator/(fixed_vec a, const fixed_vec& b) { return a /= b; }
+
+        friend constexpr fixed_vec operator*(fixed_vec a, const Fx& s) { return a *= s; }
+        friend constexpr fixed_vec operator*(const Fx& s, fixed_vec a) { return a *= s; }
+        friend constexpr fixed_vec operator/(fixed_vec a, const Fx& s) { return a /= s; }
+
+        friend constexpr fixed_vec operator-(const fixed_vec& a) { return fixed_vec { } - a; }
+
+        friend constexpr bool operator==(const fixed_vec& a, const fixed_vec& b) noexcept
+        {
+            bool eq = true;
+            for (std::size_t i = 0; i < N; ++i) eq &= a.v[i] == b.v[i];
+            return eq;
+        }
+    };
+
+    // Sum of a[i] * b[i].  Products are accumulated at full precision, in
+    // the type of the product by default.
+    template<typename Acc = void, typename Fx, std::size_t N>
+    constexpr auto dot(const fixed_vec<Fx, N>& a, const fixed_vec<Fx, N>& b)
+    {
+        using R = std::conditional_t<std::is_void_v<Acc>, detail::fixed_product_t<Fx>, Acc>;
+        R sum { 0 };
+        for (std::size_t i = 0; i < N; ++i)
+            sum += round_to<R>(a[i] * b[i]);
+        return sum;
+    }
+
+    template<typename Fx>
+    constexpr fixed_vec<Fx, 3> cross(const fixed_vec<Fx, 3>& a, const fixed_vec<Fx, 3>& b)
+    {
+        auto c = [&](std::size_t i, std::size_t j) { return round_to<Fx>(a[i] * b[j] - a[j] * b[i]); };
+        return { c(1, 2), c(2, 0), c(0, 1) };
+    }
+
+    // R x C matrix of fixed-point values.  Stored in column-major order, so
+    // that a matrix-vector product is a sum of scaled columns, which maps
+    // onto vertical SIMD operations.
+    template<typename Fx, std::size_t R, std::size_t C> requires (is_fixed<Fx> and R > 0 and C > 0)
+    struct fixed_mat
+    {
+        using value_type = Fx;
+        using column_type = fixed_vec<Fx, R>;
+
+        column_type col[C];
+
+        static constexpr std::size_t rows() noexcept { return R; }
+        static constexpr std::size_t columns() noexcept { return C; }
+
+        static constexpr fixed_mat identity() requires (R == C)
+        {
+            fixed_mat m { };
+            for (std::size_t i = 0; i < R; ++i) m.col[i][i] = Fx { 1 };
+            return m;
+        }
+
+        // Element at row i, column j.
+        constexpr Fx& operator()(std::size_t i, std::size_t j) noexcept { return col[j][i]; }
+        constexpr const Fx& operator()(std::size_t i, std::size_t j) const noexcept { return col[j][i]; }
+
+        constexpr column_type& column(std::size_t j) noexcept { return col[j]; }
+        constexpr const column_type& column(std::size_t j) const noexcept { return col[j]; }
+
+        constexpr fixed_mat& operator+=(const fixed_mat& o) { for (std::size_t j = 0; j < C; ++j) col[j] += o.col[j]; return *this; }
+        constexpr fixed_mat& operator-=(const fixed_mat& o) { for (std::size_t j = 0; j < C; ++j) col[j] -= o.col[j]; return *this; }
+        constexpr fixed_mat& operator*=(const Fx& s) { for (auto& c : col) c *= s; return *this; }
+
+        friend constexpr fixed_mat operator+(fixed_mat a, const fixed_mat& b) { return a += b; }
+        friend constexpr fixed_mat operator-(fixed_mat a, const fixed_mat& b) { return a -= b; }
+        friend constexpr fixed_mat operator*(fixed_mat a, const Fx& s) { return a *= s; }
+        friend constexpr fixed_mat operator*(const Fx& s, fixed_mat a) { return a *= s; }
+
+        friend constexpr bool operator==(const fixed_mat& a, const fixed_mat& b) noexcept
+        {
+            bool eq = true;
+            for (std::size_t j = 0; j < C; ++j) eq &= a.col[j] == b.col[j];
+            return eq;
+        }
+    };
+
+    // Matrix-vector product.  Each component is accumulated at full
+    // precision, then rounded to Fx.
+    template<typename Fx, std::size_t R, std::size_t C>
+    constexpr fixed_vec<Fx, R> operator*(const fixed_mat<Fx, R, C>& m, const fixed_vec<Fx, C>& v)
+    {
+        using W = detail::fixed_product_t<Fx>;
+        W acc[R] { };
+        for (std::size_t j = 0; j < C; ++j)
+            for (std::size_t i = 0; i < R; ++i)
+                acc[i] += m.col[j][i] * v[j];
+        fixed_vec<Fx, R> r;
+        for (std::size_t i = 0; i < R; ++i)
+            r[i] = round_to<Fx>(acc[i]);
+        return r;
+    }
+
+    template<typename Fx, std::size_t R, std::size_t N, std::size_t C>
+    constexpr fixed_mat<Fx, R, C> operator*(const fixed_mat<Fx, R, N>& a, const fixed_mat<Fx, N, C>& b)
+    {
+        fixed_mat<Fx, R, C> r;
+        for (std::size_t j = 0; j < C; ++j)
+            r.col[j] = a * b.col[j];
+        return r;
+    }
+
+    template<typename Fx, std::size_t R, std::size_t C>
+    constexpr fixed_mat<Fx, C, R> transpose(const fixed_mat<Fx, R, C>& m) noexcept
+    {
+        fixed_mat<Fx, C, R> r;
+        for (std::size_t i = 0; i < R; ++i)
+            for (std::size_t j = 0; j < C; ++j)
+                r(j, i) = m(i, j);
+        return r;
+    }
+}
@@ -16,6 +16,8 @@ namespace jw
     struct trivial_function;
     template<typename, unsigned = 1>
     struct function;
+    template<unsigned, typename...>
+    struct overload_function;
 
     // A simple std::function alternative that never allocates.  It contains
     // enough space to store a lambda that captures N pointer-sized objects.
@@ -79,7 +81,7 @@ namespace jw
             struct { } nothing { };
             alignas(dummy) std::byte storage[sizeof(dummy)];
         };
-        R(*call)(const void*, A&&...) { nullptr };
+        R(*call)(const void*, detail::thunk_arg<A>...) { nullptr };
     };
 
     template<typename F, typename Signature = typename detail::member_function_signature<decltype(&F::operator())>::type>
@@ -87,12 +89,19 @@ namespace jw
 
     // A fixed-size function object that can store non-trivial lambdas.  It is
     // larger than trivial_function and requires the use of virtual function
-    // calls on copy/move/destroy.
+    // calls on copy/move/destroy.  Trivially copyable lambdas are detected
+    // automatically, and are then copied and moved with a simple memcpy.
     template<typename R, typename... A, unsigned N>
     struct function<R(A...), N>
     {
         constexpr function() noexcept = default;
-        constexpr ~function() { if (call != nullptr) vtable->destroy(&storage); }
+        constexpr ~function() { if (vtable != nullptr) vtable->destroy(&storage); }
+
+        function(function&& other) noexcept { move_from(other); }
+        function(const function& other) { copy_from(other); }
+
+        function& operator=(function&& other) noexcept { return assign(std::move(other)); }
+        function& operator=(const function& other) { return assign(other); }
 
         template<typename F>
         function& operator=(F&& func) { return assign(std::forward<F>(func)); }
@@ -102,25 +111,16 @@ namespace jw
         template<typename F> requires (not detail::is_function_instance<std::remove_cvref_t<F>>)
         explicit function(F&& func) : function { create(std::forward<F>(func)) } { }
 
-        template<unsigned M> requires (M <= N)
-        function(function<R(A...), M>&& other) : vtable { other.vtable }, call { other.call }
-        {
-            if (call == nullptr) return;
-            vtable->move(&storage, &other.storage);
-            other.call = nullptr;
-        }
+        template<unsigned M> requires (M < N)
+        function(function<R(A...), M>&& other) noexcept { move_from(other); }
 
-        template<unsigned M> requires (M <= N)
-        function(const function<R(A...), M>& other) noexcept : vtable { other.vtable }, call { other.call }
-        {
-            if (call == nullptr) return;
-            vtable->copy(&storage, &other.storage);
-        }
+        template<unsigned M> requires (M < N)
+        function(const function<R(A...), M>& other) { copy_from(other); }
 
         template<unsigned M> requires (M <= N)
-        function(const trivial_function<R(A...), M>& other) noexcept : vtable { detail::functor_vtable::trivial<sizeof(other.storage)>() }, call { other.call }
+        function(const trivial_function<R(A...), M>& other) noexcept : call { other.call }
         {
-            std::memcpy(&storage, &other.storage, sizeof(storage));
+            std::memcpy(&storage, &other.storage, sizeof(other.storage));
         }
 
         R operator()(A... args) const { return call(&storage, std::forward<A>(args)...); }
@@ -135,38 +135,120 @@ namespace jw
             using functor = detail::functor<std::remove_cvref_t<F>>;
             static_assert(sizeof(functor) <= sizeof(dummy));
             static_assert(alignof(functor) <= alignof(dummy));
+            static_assert(std::is_nothrow_move_constructible_v<functor>, "Moving a function may not throw");
             function f;
             new (&f.storage) functor { std::forward<F>(func) };
             f.call = functor::template call<R, A...>;
-            f.vtable = detail::functor_vtable::create<std::remove_cvref_t<F>>();
+            if constexpr (not detail::is_trivial_functor<functor>)
+                f.vtable = detail::functor_vtable::create<std::remove_cvref_t<F>>();
             return f;
         }
 
         template <typename F>
         function& assign(F&& other)
         {
+            if constexpr (std::is_same_v<std::remove_cvref_t<F>, function>)
+                if (&other == this) return *this;
             this->~function();
             return *new(this) function { std::forward<F>(other) };
         }
 
+        // A null vtable indicates that the stored functor is trivially
+        // copyable and destructible, so no indirect calls are needed.  The
+        // source is left empty either way.
+        template<unsigned M>
+        void move_from(function<R(A...), M>& other) noexcept
+        {
+            vtable = other.vtable;
+            call = other.call;
+            if (vtable == nullptr)
+                std::memcpy(&storage, &other.storage, sizeof(other.storage));
+            else
+                vtable->move(&storage, &other.storage);
+            other.vtable = nullptr;
+            other.call = nullptr;
+        }
+
+        template<unsigned M>
+        void copy_from(const function<R(A...), M>& other)
+        {
+            if (other.vtable == nullptr)
+                std::memcpy(&storage, &other.storage, sizeof(other.storage));
+            else
+                other.vtable->copy(&storage, &other.storage);
+            vtable = other.vtable;
+            call = other.call;
+        }
+
         template<typename, unsigned> friend struct function;
         using dummy = trivial_function<R(A...), N>::dummy;
 
         union
         {
             struct { } nothing { };
-            struct
-            {
-                alignas(dummy) std::byte storage[sizeof(dummy)];
-                const detail::functor_vtable* vtable;
-            };
+            alignas(dummy) std::byte storage[sizeof(dummy)];
         };
-        R(*call)(const void*, A&&...) { nullptr };
+        const detail::functor_vtable* vtable { nullptr };
+        R(*call)(const void*, detail::thunk_arg<A>...) { nullptr };
     };
 
     template<typename F, typename Signature = typename detail::member_function_signature<decltype(&F::operator())>::type>
     function(F) -> function<Signature, (sizeof(F) - 1) / sizeof(void*) + 1>;
 
+    // Like trivial_function, but exposes multiple call signatures for a
+    // single stored callable.  The call thunks for each signature are kept
+    // together in one static table, so this is only one pointer larger
+    // than trivial_function.
+    template<unsigned N, typename... Sig>
+    struct overload_function : detail::overload_calls<overload_function<N, Sig...>, std::index_sequence_for<Sig...>, Sig...>
+    {
+        static_assert(sizeof...(Sig) > 0);
+
+        constexpr overload_function() noexcept = default;
+        constexpr ~overload_function() = default;
+        constexpr overload_function(overload_function&&) noexcept = default;
+        constexpr overload_function(const overload_function&) noexcept = default;
+        constexpr overload_function& operator=(overload_function&&) noexcept = default;
+        constexpr overload_function& operator=(const overload_function&) noexcept = default;
+
+        constexpr overload_function(std::nullptr_t) noexcept : overload_function { } { }
+
+        template<typename F> requires (not detail::is_function_instance<std::remove_cvref_t<F>>)
+        explicit overload_function(F&& func) : overload_function { create(std::forward<F>(func)) } { }
+
+        template<typename F>
+        overload_function& operator=(F&& func) noexcept { return *this = overload_function { std::forward<F>(func) }; }
+
+        constexpr bool valid() const noexcept { return table != nullptr; }
+        explicit constexpr operator bool() const noexcept { return valid(); }
+
+    private:
+        using table_type = std::tuple<typename detail::thunk_type<Sig>::type...>;
+
+        template<typename F>
+        static overload_function create(F&& func)
+        {
+            using functor = detail::functor<std::remove_cvref_t<F>>;
+            static_assert(std::is_trivially_destructible_v<functor>);
+            static_assert(sizeof(functor) <= sizeof(storage));
+            static_assert(alignof(functor) <= alignof(void*));
+            static constexpr table_type thunks { detail::thunk_for<functor, Sig>... };
+            overload_function f;
+            new (&f.storage) functor { std::forward<F>(func) };
+            f.table = &thunks;
+            return f;
+        }
+
+        template<typename, std::size_t, typename> friend struct detail::overload_call;
+
+        union
+        {
+            struct { } nothing { };
+            alignas(void*) std::byte storage[N * sizeof(void*)];
+        };
+        const table_type* table { nullptr };
+    };
+
     // A single-use function object with stored arguments.
     template<typename T>
     struct callable_tuple
@@ -201,4 +283,7 @@ namespace jw::detail
 
     template <typename Sig, unsigned N>
     inline constexpr bool is_function_instance<function<Sig, N>> = true;
+
+    template <unsigned N, typename... Sig>
+    inline constexpr bool is_function_instance<overload_function<N, Sig...>> = true;
 }
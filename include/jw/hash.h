@@ -0,0 +1,237 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <tuple>
+#include <ranges>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <variant>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <jw/checksum.h>
+#include <jw/variant.h>
+#include <jw/fixed.h>
+#include <jw/specific_int.h>
+#include <jw/split_int.h>
+#include <jw/sso_vector.h>
+
+// Composable hashing, after H. Hinnant et al., "Types Don't Know #", N3980.
+// A type describes which bytes make up its value, by overloading
+// hash_append(h, x).  The hash algorithm h is any state object with an
+// update(const void*, std::size_t) member, such as the ones in
+// checksum.h.  Combining values is left to the algorithm, so composite
+// types never need to mix hashes themselves.
+
+namespace jw
+{
+    // Final mixing step of SplitMix64 (variant 13 by D. Stafford).  A fast
+    // bijective function, where each input bit affects all output bits.
+    constexpr std::uint64_t mix64(std::uint64_t x) noexcept
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    // True for types where equal values have equal object representations,
+    // and vice versa.  Such values, and contiguous ranges of them, are
+    // hashed as raw memory.  May be specialized for user types.
+    template<typename T>
+    inline constexpr bool is_uniquely_represented = std::is_integral_v<T> or std::is_enum_v<T> or std::is_pointer_v<T>;
+
+    template<typename T, std::size_t F, fixed_overflow P>
+    inline constexpr bool is_uniquely_represented<fixed<T, F, P>> = is_uniquely_represented<T>;
+
+    template<typename T, std::size_t N, std::endian E>
+    inline constexpr bool is_uniquely_represented<detail::endian_int<T, N, E>> = true;
+
+    template<typename H>
+    concept hash_algorithm = requires (H& h, const void* p, std::size_t n) { h.update(p, n); h.value(); };
+
+    template<hash_algorithm H, typename T> requires (is_uniquely_represented<T>)
+    void hash_append(H& h, const T& x) noexcept;
+
+    template<hash_algorithm H, std::floating_point T>
+    void hash_append(H& h, T x) noexcept;
+
+    template<hash_algorithm H>
+    void hash_append(H& h, std::nullptr_t) noexcept;
+
+    template<hash_algorithm H, typename T, std::size_t N>
+    void hash_append(H& h, const detail::specific_int<T, N>& x) noexcept;
+
+    template<hash_algorithm H, typename T, std::size_t N, typename B>
+    void hash_append(H& h, const detail::split_int<T, N, B>& x) noexcept;
+
+    template<hash_algorithm H, std::ranges::input_range R>
+    void hash_append(H& h, const R& range);
+
+    template<hash_algorithm H, std::ranges::contiguous_range R>
+    void hash_append(H& h, const R& range);
+
+    template<hash_algorithm H, typename A, typename B>
+    void hash_append(H& h, const std::pair<A, B>& x);
+
+    template<hash_algorithm H, typename... T>
+    void hash_append(H& h, const std::tuple<T...>& x);
+
+    template<hash_algorithm H, typename... T>
+    void hash_append(H& h, const std::variant<T...>& x);
+
+    // Hash multiple values in sequence.
+    template<hash_algorithm H, typename T, typename... U> requires (sizeof...(U) > 0)
+    void hash_append(H& h, const T& x, const U&... xs)
+    {
+        hash_append(h, x);
+        (hash_append(h, xs), ...);
+    }
+
+    template<hash_algorithm H, typename T> requires (is_uniquely_represented<T>)
+    void hash_append(H& h, const T& x) noexcept
+    {
+        h.update(&x, sizeof(x));
+    }
+
+    // Positive and negative zero compare equal, so they must hash equal.
+    // NaN is hashed as-is: it never compares equal, so different NaNs may
+    // hash differently.  The x87 80-bit long double is padded to 12 or 16
+    // bytes, and only its first 10 bytes are hashed.
+    template<hash_algorithm H, std::floating_point T>
+    void hash_append(H& h, T x) noexcept
+    {
+        static_assert(std::numeric_limits<T>::is_iec559, "unsupported floating-point format");
+        constexpr std::size_t size = std::numeric_limits<T>::digits == 64 ? 10 : sizeof(T);
+        if (x == 0) x = 0;
+        h.update(&x, size);
+    }
+
+    template<hash_algorithm H>
+    void hash_append(H& h, std::nullptr_t) noexcept
+    {
+        hash_append(h, static_cast<const void*>(nullptr));
+    }
+
+    // Bit-field integers contain padding, so these are hashed by value.
+    // The result is the same as for an integer of type std::[u]intmax_t.
+    template<hash_algorithm H, typename T, std::size_t N>
+    void hash_append(H& h, const detail::specific_int<T, N>& x) noexcept
+    {
+        hash_append(h, static_cast<std::conditional_t<std::is_signed_v<T>, std::intmax_t, std::uintmax_t>>(x.value));
+    }
+
+    template<hash_algorithm H, typename T, std::size_t N, typename B>
+    void hash_append(H& h, const detail::split_int<T, N, B>& x) noexcept
+    {
+        hash_append(h, static_cast<std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>(x.value));
+    }
+
+    // Ranges are hashed element by element, followed by their size, so
+    // that nested ranges are not ambiguous.
+    template<hash_algorithm H, std::ranges::input_range R>
+    void hash_append(H& h, const R& range)
+    {
+        std::size_t n = 0;
+        for (const auto& x : range)
+        {
+            hash_append(h, x);
+            ++n;
+        }
+        hash_append(h, n);
+    }
+
+    // Contiguous ranges of uniquely represented values are hashed in one
+    // step.  This gives the same result as hashing each element.
+    template<hash_algorithm H, std::ranges::contiguous_range R>
+    void hash_append(H& h, const R& range)
+    {
+        using T = std::remove_cvref_t<std::ranges::range_reference_t<const R>>;
+        const std::size_t n = std::ranges::size(range);
+        if constexpr (is_uniquely_represented<T>)
+            h.update(std::ranges::data(range), n * sizeof(T));
+        else for (const auto& x : range)
+            hash_append(h, x);
+        hash_append(h, n);
+    }
+
+    template<hash_algorithm H, typename A, typename B>
+    void hash_append(H& h, const std::pair<A, B>& x)
+    {
+        hash_append(h, x.first, x.second);
+    }
+
+    template<hash_algorithm H, typename... T>
+    void hash_append(H& h, const std::tuple<T...>& x)
+    {
+        std::apply([&h](const auto&... xs) { (hash_append(h, xs), ...); }, x);
+    }
+
+    // The index of the active alternative is included, so that equal
+    // values of different alternatives hash differently.
+    template<hash_algorithm H, typename... T>
+    void hash_append(H& h, const std::variant<T...>& x)
+    {
+        hash_append(h, x.index());
+        if (not x.valueless_by_exception())
+            jw::visit([&h](const auto& v) { hash_append(h, v); }, x);
+    }
+
+    // Hash function object, for any type that supports hash_append().
+    // The algorithm H defaults to XXH64.
+    template<hash_algorithm H = xxh64_hash>
+    struct hasher
+    {
+        using result_type = decltype(std::declval<const H&>().value());
+
+        template<typename T>
+        result_type operator()(const T& x) const noexcept(noexcept(hash_append(std::declval<H&>(), x)))
+        {
+            H h { };
+            hash_append(h, x);
+            return h.value();
+        }
+    };
+}
+
+// Single integers are hashed with mix64() directly.  Other types use
+// jw::hasher<>.
+
+template<typename T, std::size_t F, jw::fixed_overflow P>
+struct std::hash<jw::fixed<T, F, P>>
+{
+    std::size_t operator()(const jw::fixed<T, F, P>& x) const noexcept
+    {
+        if constexpr (sizeof(T) <= 8) return jw::mix64(static_cast<std::uint64_t>(x.value));
+        else return jw::hasher<> { }(x);
+    }
+};
+
+template<typename T, std::size_t N>
+struct std::hash<jw::detail::specific_int<T, N>>
+{
+    std::size_t operator()(const jw::detail::specific_int<T, N>& x) const noexcept
+    {
+        return jw::mix64(static_cast<std::uint64_t>(x.value));
+    }
+};
+
+template<typename T, std::size_t N, typename B>
+struct std::hash<jw::detail::split_int<T, N, B>>
+{
+    std::size_t operator()(const jw::detail::split_int<T, N, B>& x) const noexcept
+    {
+        return jw::mix64(static_cast<std::uint64_t>(x.value));
+    }
+};
+
+template<typename T, std::size_t N, typename A>
+struct std::hash<jw::sso_vector<T, N, A>>
+{
+    std::size_t operator()(const jw::sso_vector<T, N, A>& x) const noexcept(noexcept(jw::hasher<> { }(x)))
+    {
+        return jw::hasher<> { }(x);
+    }
+};
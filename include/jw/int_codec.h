@@ -0,0 +1,407 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <bit>
+#include <span>
+#include <array>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <jw/common.h>
+#include <jw/specific_int.h>
+#include <jw/packed_array.h>
+#include <jw/detail/simd.h>
+
+// Compression for sequences of integers or specific_int values, by
+// frame-of-reference bit-packing, as in FastPFor.  Values are encoded in
+// blocks of up to 128.  Each block stores the smallest value, and the
+// offsets from it with the smallest bit width that fits them all.  An
+// optional transform is applied first: delta encoding turns slowly
+// changing series into small differences.
+//
+// Block format (all fields little-endian):
+//   1 byte     number of values - 1
+//   1 byte     bit width b, 0 - 64
+//   8 bytes    reference value
+//   b bytes    for each group of eight values, zero-padded
+
+namespace jw
+{
+    enum class int_transform
+    {
+        none,       // Encode values directly.
+        delta,      // Encode differences between successive values.
+        zigzag      // As delta, with zig-zag coding of the differences.
+    };
+
+    // Exception type thrown when decoding malformed input.
+    struct int_codec_error : std::runtime_error
+    {
+        int_codec_error() : runtime_error { "malformed integer stream" } { }
+        int_codec_error(const int_codec_error&) noexcept = default;
+        int_codec_error& operator=(const int_codec_error&) noexcept = default;
+    };
+}
+
+namespace jw::detail
+{
+    template<typename T>
+    struct codec_traits
+    {
+        static_assert(std::integral<T> and sizeof(T) <= 8);
+        using int_type = T;
+    };
+
+    template<typename S, std::size_t N>
+    struct codec_traits<specific_int<S, N>>
+    {
+        using int_type = typename packed_traits<specific_int<S, N>>::int_type;
+    };
+
+    inline constexpr std::size_t codec_block_size = 128;
+    inline constexpr std::size_t codec_header_size = 10;
+
+    template<std::size_t B>
+    void codec_pack(byte* out, const std::uint64_t* v, std::size_t groups) noexcept
+    {
+        simd_dispatch([out, v, groups]
+        {
+            for (std::size_t g = 0; g < groups; ++g)
+                packed_bits<B, false>::pack_group(out + g * B, v + g * 8);
+        });
+    }
+
+    template<std::size_t B>
+    void codec_unpack(const byte* in, std::uint64_t* v, std::size_t groups) noexcept
+    {
+        simd_dispatch([in, v, groups]
+        {
+            for (std::size_t g = 0; g < groups; ++g)
+                packed_bits<B, false>::unpack_group(in + g * B, v + g * 8);
+        });
+    }
+
+    // Bit width is only known at runtime, so dispatch through a table with
+    // one entry for each width.
+    inline constexpr auto codec_pack_table = []<std::size_t... B>(std::index_sequence<B...>) consteval
+    {
+        return std::array<void(*)(byte*, const std::uint64_t*, std::size_t), 64> { codec_pack<B + 1>... };
+    }(std::make_index_sequence<64> { });
+
+    inline constexpr auto codec_unpack_table = []<std::size_t... B>(std::index_sequence<B...>) consteval
+    {
+        return std::array<void(*)(const byte*, std::uint64_t*, std::size_t), 64> { codec_unpack<B + 1>... };
+    }(std::make_index_sequence<64> { });
+
+    // Encode n values (1 <= n <= 128).  The previous value, for delta
+    // coding, is carried in prev.  Returns the number of bytes written.
+    template<int_transform X, typename T>
+    std::size_t codec_encode_block(const T* in, std::size_t n, std::uint64_t& prev, byte* out) noexcept
+    {
+        using I = typename codec_traits<T>::int_type;
+        constexpr std::uint64_t flip = X != int_transform::none or std::is_signed_v<I> ? std::uint64_t { 1 } << 63 : 0;
+        const std::size_t groups = (n + 7) / 8;
+        std::uint64_t key[codec_block_size];
+        std::uint64_t lo, hi;
+        simd_dispatch([in, n, groups, &prev, &key, &lo, &hi]
+        {
+            // Local copies, as stores to key may alias captured variables.
+            const std::size_t count = n, size = groups * 8;
+
+            // u[0] holds the previous value, so that the first element
+            // needs no special case.
+            std::uint64_t u[codec_block_size + 1];
+            u[0] = prev;
+            for (std::size_t i = 0; i < count; ++i)
+                u[i + 1] = static_cast<std::uint64_t>(static_cast<I>(in[i]));
+            prev = u[count];
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if constexpr (X == int_transform::none) key[i] = u[i + 1] ^ flip;
+                else
+                {
+                    const std::uint64_t d = u[i + 1] - u[i];
+                    if constexpr (X == int_transform::delta) key[i] = d ^ flip;
+                    else key[i] = (d << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(d) >> 63);
+                }
+            }
+
+            // Pad the last group by repeating the last key, which does not
+            // change the range.
+            for (std::size_t i = count; i < size; ++i)
+                key[i] = key[count - 1];
+            std::uint64_t a = ~std::uint64_t { 0 }, b = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                a = std::min(a, key[i]);
+                b = std::max(b, key[i]);
+            }
+            for (std::size_t i = 0; i < size; ++i)
+                key[i] -= a;
+            lo = a;
+            hi = b;
+        });
+
+        const unsigned bits = std::bit_width(hi - lo);
+        out[0] = static_cast<byte>(n - 1);
+        out[1] = static_cast<byte>(bits);
+        store_le<std::uint64_t>(out + 2, lo);
+        if (bits > 0) codec_pack_table[bits - 1](out + codec_header_size, key, groups);
+        return codec_header_size + groups * bits;
+    }
+
+    struct codec_block_info
+    {
+        std::size_t count;
+        std::size_t size;
+    };
+
+    // Parse a block header.  Returns a size of zero if the block is not
+    // complete.
+    inline codec_block_info codec_parse_header(const byte* in, std::size_t avail)
+    {
+        if (avail < codec_header_size) return { 0, 0 };
+        const std::size_t n = in[0] + 1;
+        const unsigned bits = in[1];
+        if (n > codec_block_size or bits > 64) throw int_codec_error { };
+        const std::size_t size = codec_header_size + (n + 7) / 8 * bits;
+        return { n, avail < size ? 0 : size };
+    }
+
+    // Decode one complete block into out.
+    template<int_transform X, typename T>
+    void codec_decode_block(const byte* in, std::size_t n, std::uint64_t& prev, T* out) noexcept
+    {
+        using I = typename codec_traits<T>::int_type;
+        constexpr std::uint64_t flip = X != int_transform::none or std::is_signed_v<I> ? std::uint64_t { 1 } << 63 : 0;
+        const unsigned bits = in[1];
+        const std::uint64_t ref = load_le<std::uint64_t>(in + 2);
+        std::uint64_t key[codec_block_size];
+        if (bits > 0) codec_unpack_table[bits - 1](in + codec_header_size, key, (n + 7) / 8);
+        else std::fill_n(key, n, 0);
+
+        if constexpr (X == int_transform::delta)
+        {
+            // Flipping the top bit is the same as adding it, so this folds
+            // into the reference value.
+            const std::uint64_t d = ref + flip;
+            std::uint64_t p = prev;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                p += key[i] + d;
+                out[i] = static_cast<T>(static_cast<I>(p));
+            }
+            prev = p;
+        }
+        else
+        {
+            simd_dispatch([n, ref, &key]
+            {
+                const std::size_t count = n;
+                const std::uint64_t r = ref;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const std::uint64_t k = key[i] + r;
+                    if constexpr (X == int_transform::zigzag) key[i] = (k >> 1) ^ (0 - (k & 1));
+                    else key[i] = k ^ flip;
+                }
+            });
+
+            if constexpr (X == int_transform::none)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    out[i] = static_cast<T>(static_cast<I>(key[i]));
+            }
+            else
+            {
+                std::uint64_t p = prev;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    p += key[i];
+                    out[i] = static_cast<T>(static_cast<I>(p));
+                }
+                prev = p;
+            }
+        }
+    }
+}
+
+namespace jw
+{
+    // One-shot encoding and decoding of complete streams.
+    template<typename T, int_transform X = int_transform::delta>
+    struct int_codec
+    {
+        using value_type = T;
+        static constexpr std::size_t block_size = detail::codec_block_size;
+
+        // Upper bound on the encoded size of n values.
+        static constexpr std::size_t max_encoded_size(std::size_t n) noexcept
+        {
+            const std::size_t blocks = (n + block_size - 1) / block_size;
+            return blocks * detail::codec_header_size + (n + 7) / 8 * 64;
+        }
+
+        // Encode all values.  The output must have room for
+        // max_encoded_size(in.size()) bytes.  Returns the number of bytes
+        // written.
+        static std::size_t encode(std::span<const T> in, std::span<byte> out) noexcept
+        {
+            assert(out.size() >= max_encoded_size(in.size()));
+            std::uint64_t prev = 0;
+            std::size_t size = 0;
+            for (std::size_t i = 0; i < in.size(); i += block_size)
+            {
+                const std::size_t n = std::min(block_size, in.size() - i);
+                size += detail::codec_encode_block<X>(in.data() + i, n, prev, out.data() + size);
+            }
+            return size;
+        }
+
+        // Number of values in an encoded stream.
+        static std::size_t decoded_size(std::span<const byte> in)
+        {
+            std::size_t count = 0;
+            for (std::size_t pos = 0; pos < in.size(); )
+            {
+                const auto b = detail::codec_parse_header(in.data() + pos, in.size() - pos);
+                if (b.size == 0) throw int_codec_error { };
+                count += b.count;
+                pos += b.size;
+            }
+            return count;
+        }
+
+        // Decode a complete stream.  The output must have room for
+        // decoded_size(in) values.  Returns the number of values decoded.
+        static std::size_t decode(std::span<const byte> in, std::span<T> out)
+        {
+            std::uint64_t prev = 0;
+            std::size_t count = 0;
+            for (std::size_t pos = 0; pos < in.size(); )
+            {
+                const auto b = detail::codec_parse_header(in.data() + pos, in.size() - pos);
+                if (b.size == 0) throw int_codec_error { };
+                assert(out.size() - count >= b.count);
+                detail::codec_decode_block<X>(in.data() + pos, b.count, prev, out.data() + count);
+                count += b.count;
+                pos += b.size;
+            }
+            return count;
+        }
+    };
+
+    // Incremental encoder.  Values are buffered until a block is complete.
+    template<typename T, int_transform X = int_transform::delta>
+    struct int_encoder
+    {
+        using value_type = T;
+
+        void put(const T& v)
+        {
+            pending[count++] = v;
+            if (count == detail::codec_block_size) flush();
+        }
+
+        void put(std::span<const T> values)
+        {
+            while (not values.empty())
+            {
+                const std::size_t n = std::min(detail::codec_block_size - count, values.size());
+                std::copy_n(values.begin(), n, pending + count);
+                count += n;
+                values = values.subspan(n);
+                if (count == detail::codec_block_size) flush();
+            }
+        }
+
+        // Encode any buffered values as a short block.
+        void flush()
+        {
+            if (count == 0) return;
+            const std::size_t size = out.size();
+            out.resize(size + detail::codec_header_size + detail::codec_block_size * 8);
+            out.resize(size + detail::codec_encode_block<X>(pending, count, prev, out.data() + size));
+            count = 0;
+        }
+
+        // Encoded output so far.  Does not include buffered values.
+        std::span<const byte> data() const noexcept { return out; }
+
+        // Discard encoded output, for instance after it has been written
+        // out.  Encoding continues where it left off.
+        void clear() noexcept { out.clear(); }
+
+    private:
+        std::vector<byte> out;
+        T pending[detail::codec_block_size];
+        std::size_t count { 0 };
+        std::uint64_t prev { 0 };
+    };
+
+    // Incremental decoder.  Input may be fed in segments that are split
+    // at any point.
+    template<typename T, int_transform X = int_transform::delta>
+    struct int_decoder
+    {
+        using value_type = T;
+
+        void feed(std::span<const byte> bytes)
+        {
+            if (pos > 0 and pos >= in.size() / 2)
+            {
+                in.erase(in.begin(), in.begin() + pos);
+                pos = 0;
+            }
+            in.insert(in.end(), bytes.begin(), bytes.end());
+        }
+
+        // Decode as many values as are available, up to out.size().
+        // Returns the number of values decoded.
+        std::size_t read(std::span<T> out)
+        {
+            std::size_t n = 0;
+            while (n < out.size())
+            {
+                if (head < tail)
+                {
+                    const std::size_t k = std::min(tail - head, out.size() - n);
+                    std::copy_n(pending + head, k, out.data() + n);
+                    head += k;
+                    n += k;
+                    continue;
+                }
+                const auto b = detail::codec_parse_header(in.data() + pos, in.size() - pos);
+                if (b.size == 0) break;
+                if (out.size() - n >= b.count)
+                {
+                    detail::codec_decode_block<X>(in.data() + pos, b.count, prev, out.data() + n);
+                    n += b.count;
+                }
+                else
+                {
+                    detail::codec_decode_block<X>(in.data() + pos, b.count, prev, pending);
+                    head = 0;
+                    tail = b.count;
+                }
+                pos += b.size;
+            }
+            return n;
+        }
+
+    private:
+        std::vector<byte> in;
+        std::size_t pos { 0 };
+        T pending[detail::codec_block_size];
+        std::size_t head { 0 };
+        std::size_t tail { 0 };
+        std::uint64_t prev { 0 };
+    };
+}
@@ -8,6 +8,23 @@
 #include <concepts>
 #include <cmath>
 #include <jw/common.h>
+#include <jw/detail/simd.h>
+
+namespace jw::detail
+{
+    // Sum of n bytes, modulo 256.
+    inline std::uint8_t sum_bytes(const byte* p, std::size_t n) noexcept
+    {
+        std::uint8_t r;
+        simd_dispatch([p, n, &r]
+        {
+            std::uint8_t sum { 0 };
+            for (std::size_t i = 0; i < n; ++i) sum += p[i];
+            r = sum;
+        });
+        return r;
+    }
+}
 
 namespace jw
 {
@@ -51,9 +68,7 @@ namespace jw
     template<typename CharT, typename Traits> requires (sizeof(CharT) == 1)
     inline auto checksum8(const std::basic_string_view<CharT, Traits>& value)
     {
-        std::uint8_t r { 0 };
-        for (std::uint8_t c : value) r += c;
-        return r;
+        return detail::sum_bytes(reinterpret_cast<const byte*>(value.data()), value.size());
     }
 
     template<typename CharT, typename Traits, typename Alloc> requires (sizeof(CharT) == 1)
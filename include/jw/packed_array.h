@@ -0,0 +1,457 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <span>
+#include <vector>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <compare>
+#include <iterator>
+#include <initializer_list>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <jw/common.h>
+#include <jw/specific_int.h>
+#include <jw/detail/simd.h>
+
+// Arrays of specific_int<N> values, stored as a contiguous little-endian
+// bitstream of N bits per element.  Element i occupies bits [i * N,
+// i * N + N), counting from the least significant bit of the first byte.
+// Elements are accessed through proxy references, as in
+// std::vector<bool>.  Writes to an element modify the surrounding bytes,
+// so different elements may not be written concurrently.
+
+namespace jw::detail
+{
+    template<typename T>
+    struct packed_traits;
+
+    template<typename S, std::size_t N>
+    struct packed_traits<specific_int<S, N>>
+    {
+        static constexpr std::size_t bits = N;
+        static constexpr bool is_signed = std::is_signed_v<S>;
+        using int_type = std::conditional_t<is_signed, std::intmax_t, std::uintmax_t>;
+    };
+
+    // Reads and writes an N-bit field at any bit offset, through an 8-byte
+    // window.  Fields of more than 56 bits may extend into a ninth byte.
+    template<std::size_t N, bool Signed>
+    struct packed_bits
+    {
+        static_assert(N > 0 and N <= 64);
+        static constexpr std::uint64_t mask = ~std::uint64_t { 0 } >> (64 - N);
+        static constexpr std::size_t padding = N > 56 ? 9 : 8;
+
+        // Number of bytes to allocate for n elements.
+        static constexpr std::size_t bytes(std::size_t n) noexcept { return (n * N + 7) / 8 + padding; }
+
+        [[gnu::always_inline]] static std::uint64_t get(const byte* p, std::size_t bit) noexcept
+        {
+            p += bit / 8;
+            const unsigned s = bit % 8;
+            std::uint64_t v = load_le<std::uint64_t>(p) >> s;
+            if constexpr (N > 56) if (s != 0) v |= std::uint64_t { p[8] } << (64 - s);
+            v &= mask;
+            if constexpr (Signed and N < 64) v = static_cast<std::int64_t>(v << (64 - N)) >> (64 - N);
+            return v;
+        }
+
+        [[gnu::always_inline]] static void set(byte* p, std::size_t bit, std::uint64_t v) noexcept
+        {
+            p += bit / 8;
+            const unsigned s = bit % 8;
+            v &= mask;
+            store_le<std::uint64_t>(p, (load_le<std::uint64_t>(p) & ~(mask << s)) | (v << s));
+            if constexpr (N > 56) if (s != 0) p[8] = (p[8] & ~(mask >> (64 - s))) | (v >> (64 - s));
+        }
+
+        // Bulk conversion.  Eight elements take exactly N bytes, so groups of
+        // eight are aligned to whole bytes.  Within a group, all offsets are
+        // constants.
+        template<typename I>
+        static void unpack(const byte* p, std::size_t pos, I* dst, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            for (; i < n and (pos + i) % 8 != 0; ++i)
+                dst[i] = static_cast<I>(get(p, (pos + i) * N));
+            const std::size_t groups = (n - i) / 8;
+            simd_dispatch([src = p + (pos + i) / 8 * N, dst = dst + i, groups]
+            {
+                for (std::size_t g = 0; g < groups; ++g)
+                    [&]<std::size_t... J>(std::index_sequence<J...>)
+                    {
+                        ((dst[g * 8 + J] = static_cast<I>(get(src + g * N, J * N))), ...);
+                    }(std::make_index_sequence<8> { });
+            });
+            for (i += groups * 8; i < n; ++i)
+                dst[i] = static_cast<I>(get(p, (pos + i) * N));
+        }
+
+        // Unpack a group of eight elements, reading exactly N bytes.
+        template<typename I>
+        [[gnu::always_inline]] static void unpack_group(const byte* in, I* dst) noexcept
+        {
+            std::uint64_t w[N / 8 + 1] { };
+            for (std::size_t k = 0; k < N / 8; ++k)
+                w[k] = load_le<std::uint64_t>(in + 8 * k);
+            for (std::size_t k = 0; k < N % 8; ++k)
+                w[N / 8] |= std::uint64_t { in[N / 8 * 8 + k] } << (8 * k);
+            [&]<std::size_t... J>(std::index_sequence<J...>)
+            {
+                ((dst[J] = static_cast<I>(extract<J * N>(w))), ...);
+            }(std::make_index_sequence<8> { });
+        }
+
+        template<std::size_t Bit>
+        [[gnu::always_inline]] static std::uint64_t extract(const std::uint64_t* w) noexcept
+        {
+            constexpr std::size_t k = Bit / 64;
+            constexpr unsigned s = Bit % 64;
+            std::uint64_t v = w[k] >> s;
+            if constexpr (s + N > 64) v |= w[k + 1] << (64 - s);
+            v &= mask;
+            if constexpr (Signed and N < 64) v = static_cast<std::int64_t>(v << (64 - N)) >> (64 - N);
+            return v;
+        }
+
+        // A group of eight elements is assembled in a register, and written
+        // out in whole words, to avoid overlapping read-modify-write access.
+        template<typename I>
+        [[gnu::always_inline]] static void pack_group(byte* out, const I* src) noexcept
+        {
+            std::uint64_t acc = 0;
+            unsigned used = 0;
+            auto put = [&](std::uint64_t v)
+            {
+                v &= mask;
+                acc |= v << used;
+                used += N;
+                if (used >= 64)
+                {
+                    store_le(out, acc);
+                    out += 8;
+                    used -= 64;
+                    acc = used > 0 ? v >> (N - used) : 0;
+                }
+            };
+            [&]<std::size_t... J>(std::index_sequence<J...>)
+            {
+                (put(static_cast<std::uint64_t>(src[J])), ...);
+            }(std::make_index_sequence<8> { });
+            for (unsigned k = 0; k < used / 8; ++k)
+                out[k] = static_cast<byte>(acc >> (8 * k));
+        }
+
+        template<typename I>
+        static void pack(byte* p, std::size_t pos, const I* src, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            for (; i < n and (pos + i) % 8 != 0; ++i)
+                set(p, (pos + i) * N, src[i]);
+            const std::size_t groups = (n - i) / 8;
+            simd_dispatch([dst = p + (pos + i) / 8 * N, src = src + i, groups]
+            {
+                for (std::size_t g = 0; g < groups; ++g)
+                    pack_group(dst + g * N, src + g * 8);
+            });
+            for (i += groups * 8; i < n; ++i)
+                set(p, (pos + i) * N, src[i]);
+        }
+    };
+
+    template<typename T, bool Const>
+    struct packed_reference
+    {
+        using traits = packed_traits<T>;
+        using bits = packed_bits<traits::bits, traits::is_signed>;
+        using int_type = typename traits::int_type;
+        using pointer = std::conditional_t<Const, const byte*, byte*>;
+
+        packed_reference(pointer p, std::size_t i) noexcept : p { p }, i { i } { }
+        packed_reference(const packed_reference&) noexcept = default;
+
+        operator T() const noexcept { return T { get() }; }
+        operator int_type() const noexcept { return get(); }
+
+        const packed_reference& operator=(int_type v) const noexcept requires (not Const)
+        {
+            bits::set(p, i * traits::bits, v);
+            return *this;
+        }
+
+        const packed_reference& operator=(const T& v) const noexcept requires (not Const) { return *this = static_cast<int_type>(v); }
+        const packed_reference& operator=(const packed_reference& v) const noexcept requires (not Const) { return *this = v.get(); }
+
+        friend void swap(const packed_reference& a, const packed_reference& b) noexcept requires (not Const)
+        {
+            const int_type t = a;
+            a = b.get();
+            b = t;
+        }
+
+    private:
+        int_type get() const noexcept { return static_cast<int_type>(bits::get(p, i * traits::bits)); }
+
+        pointer p;
+        std::size_t i;
+    };
+
+    template<typename T, bool Const>
+    struct packed_iterator
+    {
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = packed_reference<T, Const>;
+        using pointer = void;
+        using iterator_category = std::random_access_iterator_tag;
+        using byte_pointer = typename reference::pointer;
+
+        packed_iterator() noexcept = default;
+        packed_iterator(byte_pointer p, std::size_t i) noexcept : p { p }, i { i } { }
+        packed_iterator(const packed_iterator&) noexcept = default;
+        packed_iterator& operator=(const packed_iterator&) noexcept = default;
+        packed_iterator(const packed_iterator<T, false>& other) noexcept requires (Const) : p { other.p }, i { other.i } { }
+
+        reference operator*() const noexcept { return { p, i }; }
+        reference operator[](difference_type n) const noexcept { return { p, i + n }; }
+
+        packed_iterator& operator+=(difference_type n) noexcept { i += n; return *this; }
+        packed_iterator& operator-=(difference_type n) noexcept { i -= n; return *this; }
+        packed_iterator& operator++() noexcept { ++i; return *this; }
+        packed_iterator& operator--() noexcept { --i; return *this; }
+        packed_iterator operator++(int) noexcept { return { p, i++ }; }
+        packed_iterator operator--(int) noexcept { return { p, i-- }; }
+
+        friend packed_iterator operator+(packed_iterator a, difference_type n) noexcept { return a += n; }
+        friend packed_iterator operator+(difference_type n, packed_iterator a) noexcept { return a += n; }
+        friend packed_iterator operator-(packed_iterator a, difference_type n) noexcept { return a -= n; }
+        friend difference_type operator-(const packed_iterator& a, const packed_iterator& b) noexcept { return a.i - b.i; }
+
+        friend bool operator==(const packed_iterator& a, const packed_iterator& b) noexcept { return a.i == b.i; }
+        friend auto operator<=>(const packed_iterator& a, const packed_iterator& b) noexcept { return a.i <=> b.i; }
+
+    private:
+        template<typename, bool> friend struct packed_iterator;
+        byte_pointer p { };
+        std::size_t i { };
+    };
+
+    // Element access and bulk conversion, for packed_array and
+    // packed_vector.  Derived classes provide data() and size().
+    template<typename D, typename T>
+    struct packed_interface
+    {
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = packed_reference<T, false>;
+        using const_reference = packed_reference<T, true>;
+        using iterator = packed_iterator<T, false>;
+        using const_iterator = packed_iterator<T, true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using int_type = typename packed_traits<T>::int_type;
+
+        static constexpr std::size_t element_bits = packed_traits<T>::bits;
+
+        reference       operator[](size_type i)       noexcept { return { self()->data(), i }; }
+        const_reference operator[](size_type i) const noexcept { return { self()->data(), i }; }
+
+        reference       at(size_type i)       { check_pos(i); return (*this)[i]; }
+        const_reference at(size_type i) const { check_pos(i); return (*this)[i]; }
+
+        reference       front()       noexcept { return (*this)[0]; }
+        const_reference front() const noexcept { return (*this)[0]; }
+        reference       back()        noexcept { return (*this)[self()->size() - 1]; }
+        const_reference back()  const noexcept { return (*this)[self()->size() - 1]; }
+
+        iterator        begin()       noexcept { return { self()->data(), 0 }; }
+        const_iterator  begin() const noexcept { return { self()->data(), 0 }; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator        end()       noexcept { return { self()->data(), self()->size() }; }
+        const_iterator  end() const noexcept { return { self()->data(), self()->size() }; }
+        const_iterator cend() const noexcept { return end(); }
+
+        reverse_iterator        rbegin()       noexcept { return reverse_iterator { end() }; }
+        const_reverse_iterator  rbegin() const noexcept { return const_reverse_iterator { end() }; }
+        reverse_iterator        rend()       noexcept { return reverse_iterator { begin() }; }
+        const_reverse_iterator  rend() const noexcept { return const_reverse_iterator { begin() }; }
+
+        bool empty() const noexcept { return self()->size() == 0; }
+
+        // The packed bitstream, without padding.
+        std::span<const byte> bytes() const noexcept { return { self()->data(), (self()->size() * element_bits + 7) / 8 }; }
+
+        // Convert elements [pos, pos + dst.size()) to native integers.
+        template<std::integral I>
+        void unpack(size_type pos, std::span<I> dst) const noexcept
+        {
+            assert(pos + dst.size() <= self()->size());
+            bits::unpack(self()->data(), pos, dst.data(), dst.size());
+        }
+
+        // Store native integers in elements [pos, pos + src.size()).  Values
+        // are truncated to N bits.
+        template<std::integral I>
+        void pack(size_type pos, std::span<const I> src) noexcept
+        {
+            assert(pos + src.size() <= self()->size());
+            bits::pack(self()->data(), pos, src.data(), src.size());
+        }
+
+        template<std::integral I>
+        void pack(size_type pos, std::span<I> src) noexcept { pack(pos, std::span<const I> { src }); }
+
+        void fill(int_type v) noexcept
+        {
+            for (auto&& x : *this) x = v;
+        }
+
+        friend bool operator==(const D& a, const D& b) noexcept
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                              [](int_type x, int_type y) { return x == y; });
+        }
+
+    protected:
+        using bits = packed_bits<element_bits, packed_traits<T>::is_signed>;
+
+    private:
+        D* self() noexcept { return static_cast<D*>(this); }
+        const D* self() const noexcept { return static_cast<const D*>(this); }
+
+        void check_pos(size_type i) const
+        {
+            if (i >= self()->size()) throw std::out_of_range { "packed array index out of range" };
+        }
+    };
+}
+
+namespace jw
+{
+    // Fixed-size array of Size bit-packed specific_int values.
+    // Zero-initialized.
+    template<typename T, std::size_t Size>
+    struct packed_array : detail::packed_interface<packed_array<T, Size>, T>
+    {
+        using base = detail::packed_interface<packed_array<T, Size>, T>;
+
+        constexpr packed_array() noexcept = default;
+
+        packed_array(std::initializer_list<typename base::int_type> values) noexcept
+        {
+            assert(values.size() <= Size);
+            base::pack(0, std::span { values.begin(), values.size() });
+        }
+
+        static constexpr std::size_t size() noexcept { return Size; }
+        static constexpr std::size_t max_size() noexcept { return Size; }
+
+        byte* data() noexcept { return storage; }
+        const byte* data() const noexcept { return storage; }
+
+    private:
+        byte storage[base::bits::bytes(Size)] { };
+    };
+
+    // Resizable array of bit-packed specific_int values.
+    template<typename T, typename Alloc = std::allocator<byte>>
+    struct packed_vector : detail::packed_interface<packed_vector<T, Alloc>, T>
+    {
+        using base = detail::packed_interface<packed_vector<T, Alloc>, T>;
+        using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<byte>;
+        using int_type = typename base::int_type;
+
+        packed_vector() noexcept(noexcept(allocator_type { })) = default;
+        explicit packed_vector(const allocator_type& alloc) noexcept : storage { alloc } { }
+        explicit packed_vector(std::size_t n, const allocator_type& alloc = { }) : storage { alloc } { resize(n); }
+
+        packed_vector(std::initializer_list<int_type> values, const allocator_type& alloc = { }) : storage { alloc }
+        {
+            resize(values.size());
+            base::pack(0, std::span { values.begin(), values.size() });
+        }
+
+        // Construct from native integers.
+        template<std::integral I>
+        explicit packed_vector(std::span<const I> values, const allocator_type& alloc = { }) : storage { alloc }
+        {
+            resize(values.size());
+            base::pack(0, values);
+        }
+
+        std::size_t size() const noexcept { return count; }
+        std::size_t capacity() const noexcept { return storage.capacity() < base::bits::padding ? 0 : (storage.capacity() - base::bits::padding) * 8 / base::element_bits; }
+        allocator_type get_allocator() const noexcept { return storage.get_allocator(); }
+
+        byte* data() noexcept { return storage.data(); }
+        const byte* data() const noexcept { return storage.data(); }
+
+        void reserve(std::size_t n) { storage.reserve(base::bits::bytes(n)); }
+        void shrink_to_fit() { storage.shrink_to_fit(); }
+        void clear() noexcept { resize(0); }
+
+        // New elements are zero.
+        void resize(std::size_t n)
+        {
+            if (n > count)
+            {
+                const std::size_t bit = count * base::element_bits;
+                storage.resize(base::bits::bytes(n));
+                byte* const p = storage.data() + bit / 8;
+                *p &= (1u << (bit % 8)) - 1;
+                std::fill(p + 1, storage.data() + storage.size(), 0);
+            }
+            else if (n == 0) storage.clear();
+            else storage.resize(base::bits::bytes(n));
+            count = n;
+        }
+
+        void resize(std::size_t n, int_type v)
+        {
+            const std::size_t old = count;
+            resize(n);
+            for (auto i = old; i < n; ++i) (*this)[i] = v;
+        }
+
+        void push_back(int_type v)
+        {
+            resize(count + 1);
+            this->back() = v;
+        }
+
+        void pop_back() noexcept { resize(count - 1); }
+
+        // Append native integers.
+        template<std::integral I>
+        void append(std::span<const I> values)
+        {
+            const std::size_t pos = count;
+            resize(count + values.size());
+            base::pack(pos, values);
+        }
+
+        void swap(packed_vector& other) noexcept
+        {
+            using std::swap;
+            swap(storage, other.storage);
+            swap(count, other.count);
+        }
+
+    private:
+        std::vector<byte, allocator_type> storage;
+        std::size_t count { 0 };
+    };
+
+    template<typename T, typename A>
+    void swap(packed_vector<T, A>& a, packed_vector<T, A>& b) noexcept
+    {
+        a.swap(b);
+    }
+}
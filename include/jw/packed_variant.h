@@ -0,0 +1,135 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <algorithm>
+#include <type_traits>
+#include <jw/variant.h>
+
+namespace jw
+{
+    template<typename...>
+    struct packed_variant;
+}
+
+namespace std
+{
+    template<typename... T>
+    struct variant_size<jw::packed_variant<T...>> : std::integral_constant<std::size_t, sizeof...(T)> { };
+
+    template<std::size_t I, typename... T>
+    struct variant_alternative<I, jw::packed_variant<T...>> { using type = std::tuple_element_t<I, std::tuple<T...>>; };
+}
+
+namespace jw::detail
+{
+    template<std::size_t N>
+    using variant_index_type = std::conditional_t<(N <= 0xff), std::uint8_t,
+                               std::conditional_t<(N <= 0xffff), std::uint16_t, std::uint32_t>>;
+}
+
+namespace jw
+{
+    // A std::variant alternative without padding or alignment requirement,
+    // for trivially copyable types.  The index is stored in the smallest
+    // possible integer type, directly after the largest alternative.  For
+    // example, packed_variant<uint32_t, float> takes 5 bytes, where
+    // std::variant takes 8.
+    // Since alternatives may be misaligned, they are only accessed by
+    // value: get() returns a copy, and emplace() or assignment replaces the
+    // value.  New values are built in a temporary first, so this variant
+    // is never valueless.  Works with jw::visit, variant_index() and
+    // variant_contains().
+    template<typename... T>
+    struct [[gnu::packed]] packed_variant
+    {
+        static_assert(sizeof...(T) > 0);
+        static_assert((std::is_trivially_copyable_v<T> and ...));
+
+        using index_type = detail::variant_index_type<sizeof...(T)>;
+
+        template<std::size_t I>
+        using alternative = std::variant_alternative_t<I, packed_variant>;
+
+        packed_variant() noexcept(std::is_nothrow_default_constructible_v<alternative<0>>) { emplace<0>(); }
+
+        template<std::size_t I, typename... A>
+        explicit packed_variant(std::in_place_index_t<I>, A&&... args) { emplace<I>(std::forward<A>(args)...); }
+
+        template<typename U, typename... A>
+        explicit packed_variant(std::in_place_type_t<U>, A&&... args) { emplace<index_of<U>>(std::forward<A>(args)...); }
+
+        template<typename U> requires (variant_contains<packed_variant, std::remove_cvref_t<U>>())
+        packed_variant(U&& value) { emplace<index_of<std::remove_cvref_t<U>>>(std::forward<U>(value)); }
+
+        packed_variant(const packed_variant&) noexcept = default;
+        packed_variant(packed_variant&&) noexcept = default;
+        packed_variant& operator=(const packed_variant&) noexcept = default;
+        packed_variant& operator=(packed_variant&&) noexcept = default;
+
+        template<typename U> requires (variant_contains<packed_variant, std::remove_cvref_t<U>>())
+        packed_variant& operator=(U&& value)
+        {
+            emplace<index_of<std::remove_cvref_t<U>>>(std::forward<U>(value));
+            return *this;
+        }
+
+        std::size_t index() const noexcept { return idx; }
+        constexpr bool valueless_by_exception() const noexcept { return false; }
+
+        template<std::size_t I, typename... A>
+        alternative<I> emplace(A&&... args)
+        {
+            using U = alternative<I>;
+            alignas(U) std::byte tmp[sizeof(U)];
+            const U* const p = std::construct_at(reinterpret_cast<U*>(tmp), std::forward<A>(args)...);
+            std::memcpy(storage, tmp, sizeof(U));
+            idx = I;
+            return *p;
+        }
+
+        template<typename U, typename... A>
+        U emplace(A&&... args) { return emplace<index_of<U>>(std::forward<A>(args)...); }
+
+        // Copy out alternative I, which must be active.
+        template<std::size_t I>
+        alternative<I> value() const noexcept
+        {
+            using U = alternative<I>;
+            alignas(U) std::byte tmp[sizeof(U)];
+            std::memcpy(tmp, storage, sizeof(U));
+            return *std::launder(reinterpret_cast<const U*>(tmp));
+        }
+
+    private:
+        template<typename U>
+        static constexpr std::size_t index_of = variant_index<packed_variant, U>();
+
+        std::byte storage[std::max({ sizeof(T)... })];
+        index_type idx;
+    };
+
+    template<std::size_t I, typename... T>
+    std::variant_alternative_t<I, packed_variant<T...>> get(const packed_variant<T...>& v)
+    {
+        if (v.index() != I) throw std::bad_variant_access { };
+        return v.template value<I>();
+    }
+
+    template<typename U, typename... T>
+    U get(const packed_variant<T...>& v) { return get<variant_index<packed_variant<T...>, U>()>(v); }
+
+    template<typename U, typename... T>
+    bool holds_alternative(const packed_variant<T...>& v) noexcept
+    {
+        return v.index() == variant_index<packed_variant<T...>, U>();
+    }
+}
@@ -0,0 +1,123 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <jw/common.h>
+#include <jw/function.h>
+#include <jw/sso_vector.h>
+
+namespace jw
+{
+    template<typename, unsigned = 1, typename = std::allocator<std::byte>>
+    struct signal;
+
+    // A multicast delegate, which stores its subscribers as trivial_function
+    // objects.  Invoking a signal never allocates.  Each call to connect()
+    // returns a handle which remains valid until it is passed to
+    // disconnect(), regardless of other connections being added or removed.
+    // Subscribers may safely connect or disconnect while the signal is being
+    // invoked.  Newly connected subscribers are only called on the next
+    // invocation, and slots freed during invocation are reclaimed once the
+    // outermost invocation returns.  Not thread-safe.
+    template<typename... A, unsigned N, typename Alloc>
+    struct signal<void(A...), N, Alloc>
+    {
+        static_assert((not std::is_rvalue_reference_v<A> and ...));
+
+        using function_type = trivial_function<void(A...), N>;
+        using size_type = std::size_t;
+        using allocator_type = Alloc;
+
+        struct handle { size_type index; };
+
+        signal() = default;
+        explicit signal(const Alloc& a) : slots { a }, free { a } { }
+
+        // Add a subscriber.  Amortized O(1).
+        template<typename F>
+        handle connect(F&& func)
+        {
+            const function_type f { std::forward<F>(func) };
+            ++count;
+            if (depth == 0 and not free.empty())
+            {
+                const size_type i = free.back();
+                free.pop_back();
+                slots[i] = f;
+                return { i };
+            }
+            slots.push_back(f);
+            return { slots.size() - 1 };
+        }
+
+        // Remove a subscriber.  The handle must have been obtained from
+        // connect() on this signal, and may only be disconnected once.
+        void disconnect(handle h)
+        {
+            slots[h.index] = nullptr;
+            --count;
+            if (depth == 0) free.push_back(h.index);
+            else dirty = true;
+        }
+
+        // Remove all subscribers.
+        void clear() noexcept
+        {
+            count = 0;
+            if (depth == 0)
+            {
+                slots.clear();
+                free.clear();
+                return;
+            }
+            for (auto& f : slots) f = nullptr;
+            dirty = true;
+        }
+
+        // Invoke all subscribers, in no particular order.
+        void operator()(A... args)
+        {
+            ++depth;
+            local_destructor guard { [this] { if (--depth == 0 and dirty) compact(); } };
+            const size_type n = slots.size();
+            for (size_type i = 0; i < n; ++i)
+            {
+                // Subscribers may add connections and cause reallocation, so
+                // make a local copy first.
+                const function_type f = slots[i];
+                if (f) f(args...);
+            }
+        }
+
+        // Number of connected subscribers.
+        size_type size() const noexcept { return count; }
+        bool empty() const noexcept { return count == 0; }
+
+    private:
+        // Trim unused slots from the end, and rebuild the free list.
+        void compact()
+        {
+            dirty = false;
+            while (not slots.empty() and not slots.back()) slots.pop_back();
+            free.clear();
+            for (size_type i = 0; i < slots.size(); ++i)
+                if (not slots[i]) free.push_back(i);
+        }
+
+        template<typename T>
+        using vector = sso_vector<T, 0, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+        vector<function_type> slots;
+        vector<size_type> free;
+        size_type count { 0 };
+        unsigned depth { 0 };
+        bool dirty { false };
+    };
+}
+
+namespace jw::pmr
+{
+    template<typename Sig, unsigned N = 1> using signal = jw::signal<Sig, N, std::pmr::polymorphic_allocator<std::byte>>;
+}
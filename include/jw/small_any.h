@@ -0,0 +1,235 @@
+/* * * * * * * * * * * * * * * * * * jwutil * * * * * * * * * * * * * * * * * */
+/*    Copyright (C) 2026 - 2026 J.W. Jagersma, see COPYING.txt for details    */
+
+#pragma once
+#include <any>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+#include <jw/detail/function.h>
+
+namespace jw::detail
+{
+    // Inline storage for values in a small_any.  The value is constructed
+    // in-place with parentheses, as std::any does.
+    template<typename T>
+    struct any_inline
+    {
+        template<typename... A>
+        any_inline(std::in_place_t, A&&... args) : value(std::forward<A>(args)...) { }
+
+        T value;
+    };
+
+    // Heap-allocated storage for values that do not fit in a small_any.
+    template<typename T, typename Alloc>
+    struct any_box
+    {
+        using allocator_type = std::allocator_traits<Alloc>::template rebind_alloc<T>;
+        using traits = std::allocator_traits<allocator_type>;
+
+        template<typename... A>
+        any_box(const Alloc& alloc, A&&... args) : a { alloc }, p { traits::allocate(a, 1) }
+        {
+            try { traits::construct(a, p, std::forward<A>(args)...); }
+            catch (...) { traits::deallocate(a, p, 1); throw; }
+        }
+
+        any_box(any_box&& other) noexcept : a { std::move(other.a) }, p { std::exchange(other.p, nullptr) } { }
+        any_box(const any_box& other) : any_box { traits::select_on_container_copy_construction(other.a), *other.p } { }
+
+        ~any_box()
+        {
+            if (p == nullptr) return;
+            traits::destroy(a, p);
+            traits::deallocate(a, p, 1);
+        }
+
+        [[no_unique_address]] allocator_type a;
+        T* p;
+    };
+}
+
+namespace jw
+{
+    // A std::any alternative that stores values of up to N pointer-sized
+    // objects inline.  Type identification does not require RTTI: each
+    // stored type has a unique vtable, and its address is compared.
+    // If an allocator type is given, larger values are allocated from it.
+    // Otherwise, attempting to store these results in a compile error.
+    template<unsigned N = 2, typename Alloc = void>
+    struct small_any
+    {
+        template<typename T>
+        static constexpr bool fits = sizeof(detail::functor<T>) <= N * sizeof(void*)
+                                     and alignof(detail::functor<T>) <= alignof(void*)
+                                     and std::is_nothrow_move_constructible_v<T>;
+
+        using allocator_type = std::conditional_t<std::is_void_v<Alloc>, std::allocator<std::byte>, Alloc>;
+
+        constexpr small_any() noexcept = default;
+        ~small_any() { reset(); }
+
+        small_any(small_any&& other) noexcept : vtable { other.vtable }
+        {
+            if (vtable == nullptr) return;
+            vtable->move(&storage, &other.storage);
+            other.vtable = nullptr;
+        }
+
+        small_any(const small_any& other) : vtable { nullptr }
+        {
+            if (other.vtable == nullptr) return;
+            other.vtable->copy(&storage, &other.storage);
+            vtable = other.vtable;
+        }
+
+        small_any& operator=(small_any&& other) noexcept
+        {
+            if (&other == this) return *this;
+            reset();
+            return *new (this) small_any { std::move(other) };
+        }
+
+        small_any& operator=(const small_any& other)
+        {
+            if (&other == this) return *this;
+            return *this = small_any { other };
+        }
+
+        template<typename T> requires (not std::is_same_v<std::decay_t<T>, small_any> and std::copy_constructible<std::decay_t<T>>)
+        small_any(T&& value) { emplace<std::decay_t<T>>(std::forward<T>(value)); }
+
+        template<typename T, typename... A> requires (not std::is_void_v<Alloc>)
+        small_any(std::allocator_arg_t, const allocator_type& alloc, std::in_place_type_t<T>, A&&... args)
+        {
+            emplace_with<T>(alloc, std::forward<A>(args)...);
+        }
+
+        template<typename T> requires (not std::is_same_v<std::decay_t<T>, small_any> and std::copy_constructible<std::decay_t<T>>)
+        small_any& operator=(T&& value)
+        {
+            return *this = small_any { std::forward<T>(value) };
+        }
+
+        // Destroy the current value and construct a new one in-place.  The
+        // arguments may refer to the current value.
+        template<typename T, typename... A>
+        T& emplace(A&&... args)
+        {
+            if constexpr (fits<T>) return emplace_with<T>(nullptr, std::forward<A>(args)...);
+            else return emplace_with<T>(allocator_type { }, std::forward<A>(args)...);
+        }
+
+        void reset() noexcept
+        {
+            if (vtable == nullptr) return;
+            vtable->destroy(&storage);
+            vtable = nullptr;
+        }
+
+        bool has_value() const noexcept { return vtable != nullptr; }
+
+        template<typename T>
+        bool holds() const noexcept { return vtable == vtable_for<T>(); }
+
+        template<typename T>
+        T* get() noexcept
+        {
+            if (not holds<T>()) return nullptr;
+            return pointer<T>();
+        }
+
+        template<typename T>
+        const T* get() const noexcept
+        {
+            if (not holds<T>()) return nullptr;
+            return pointer<T>();
+        }
+
+    private:
+        template<typename T>
+        using box = detail::any_box<T, allocator_type>;
+
+        template<typename T>
+        using stored = std::conditional_t<fits<T>, detail::any_inline<T>, box<T>>;
+
+        template<typename T>
+        static const detail::functor_vtable* vtable_for() noexcept
+        {
+            return detail::functor_vtable::create<stored<T>>();
+        }
+
+        template<typename T, typename A0, typename... A>
+        T& emplace_with(const A0& alloc, A&&... args)
+        {
+            using functor = detail::functor<stored<T>>;
+            static_assert(fits<T> or not std::is_void_v<Alloc>, "Type too large for small_any");
+            static_assert(fits<T> or fits<box<T>>, "Allocator too large for small_any");
+            if (vtable == nullptr) new (&storage) functor { make_stored<T>(alloc, std::forward<A>(args)...) };
+            else
+            {
+                // Arguments may refer to the current value, so construct the
+                // new one before destroying it.
+                stored<T> tmp { make_stored<T>(alloc, std::forward<A>(args)...) };
+                reset();
+                new (&storage) functor { std::move(tmp) };
+            }
+            vtable = vtable_for<T>();
+            return *pointer<T>();
+        }
+
+        template<typename T, typename A0, typename... A>
+        static stored<T> make_stored(const A0& alloc, A&&... args)
+        {
+            if constexpr (fits<T>) return detail::any_inline<T> { std::in_place, std::forward<A>(args)... };
+            else return box<T> { alloc, std::forward<A>(args)... };
+        }
+
+        template<typename T>
+        T* pointer() const noexcept
+        {
+            auto* const p = &detail::functor<stored<T>>::cast(const_cast<std::byte*>(storage))->lambda;
+            if constexpr (fits<T>) return &p->value;
+            else return p->p;
+        }
+
+        union
+        {
+            struct { } nothing { };
+            alignas(void*) std::byte storage[N * sizeof(void*)];
+        };
+        const detail::functor_vtable* vtable { nullptr };
+    };
+
+    template<typename T, unsigned N, typename A>
+    T* any_cast(small_any<N, A>* a) noexcept { return a->template get<T>(); }
+
+    template<typename T, unsigned N, typename A>
+    const T* any_cast(const small_any<N, A>* a) noexcept { return a->template get<T>(); }
+
+    template<typename T, unsigned N, typename A>
+    T any_cast(small_any<N, A>& a)
+    {
+        auto* const p = a.template get<std::remove_cvref_t<T>>();
+        if (p == nullptr) throw std::bad_any_cast { };
+        return static_cast<T>(*p);
+    }
+
+    template<typename T, unsigned N, typename A>
+    T any_cast(const small_any<N, A>& a)
+    {
+        auto* const p = a.template get<std::remove_cvref_t<T>>();
+        if (p == nullptr) throw std::bad_any_cast { };
+        return static_cast<T>(*p);
+    }
+
+    template<typename T, unsigned N, typename A>
+    T any_cast(small_any<N, A>&& a)
+    {
+        auto* const p = a.template get<std::remove_cvref_t<T>>();
+        if (p == nullptr) throw std::bad_any_cast { };
+        return static_cast<T>(std::move(*p));
+    }
+}
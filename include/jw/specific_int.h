@@ -3,6 +3,7 @@
 
 #pragma once
 #include <cstdint>
+#include <bit>
 #include <jw/common.h>
 
 #pragma GCC diagnostic push
@@ -27,11 +28,99 @@ namespace jw
             constexpr specific_int(std::integral auto v) noexcept : value { static_cast<decltype(value)>(v) } { };
             constexpr operator auto() const noexcept { return value; }
         };
+
+        // N-bit integer stored in N / 8 bytes with explicit byte order.  Has
+        // no alignment requirement, so structs of these can be overlaid on
+        // wire-format buffers directly.  For 16, 32 and 64 bits, loads and
+        // stores are a single memory access plus a byte swap, which becomes
+        // MOVBE where the target supports it.
+        template<typename T, std::size_t N, std::endian E>
+        struct [[gnu::packed]] endian_int
+        {
+            static_assert(N % 8 == 0 and N > 0 and N <= 64);
+            using type = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+            static constexpr std::endian byte_order = E;
+
+            byte bytes[N / 8];
+
+            constexpr endian_int() noexcept = default;
+            constexpr endian_int(const endian_int&) noexcept = default;
+            constexpr endian_int(endian_int&&) noexcept = default;
+            constexpr endian_int& operator=(const endian_int&) noexcept = default;
+            constexpr endian_int& operator=(endian_int&&) noexcept = default;
+
+            constexpr endian_int(std::integral auto v) noexcept { store(static_cast<type>(v)); }
+            constexpr operator type() const noexcept { return load(); }
+
+        private:
+            // Smallest unsigned type that holds N bits.
+            using U = std::conditional_t<(N <= 16), std::uint16_t, std::conditional_t<(N <= 32), std::uint32_t, std::uint64_t>>;
+            static constexpr unsigned pad = sizeof(U) * 8 - N;
+
+            // Bytes are read and written as little-endian, in power-of-two
+            // sized pieces, so that odd sizes take no more than three
+            // accesses.  Big-endian values are byte-swapped after that.
+            template<typename C>
+            [[gnu::always_inline]] void load_piece(U& raw, std::size_t& i) const noexcept
+            {
+                if (N / 8 - i < sizeof(C)) return;
+                raw |= static_cast<U>(static_cast<U>(load_le<C>(bytes + i)) << (8 * i));
+                i += sizeof(C);
+            }
+
+            template<typename C>
+            [[gnu::always_inline]] void store_piece(U raw, std::size_t& i) noexcept
+            {
+                if (N / 8 - i < sizeof(C)) return;
+                store_le<C>(bytes + i, static_cast<C>(raw >> (8 * i)));
+                i += sizeof(C);
+            }
+
+            constexpr type load() const noexcept
+            {
+                U raw { 0 };
+                if (std::is_constant_evaluated())
+                    for (std::size_t i = 0; i < N / 8; ++i) raw |= static_cast<U>(U { bytes[i] } << (8 * i));
+                else
+                {
+                    std::size_t i = 0;
+                    load_piece<std::uint64_t>(raw, i);
+                    load_piece<std::uint32_t>(raw, i);
+                    load_piece<std::uint16_t>(raw, i);
+                    load_piece<std::uint8_t>(raw, i);
+                }
+                if constexpr (E == std::endian::big) raw = byteswap(raw) >> pad;
+                if constexpr (std::is_signed_v<T>)
+                    return static_cast<std::make_signed_t<U>>(raw << pad) >> pad;
+                else return raw;
+            }
+
+            constexpr void store(type v) noexcept
+            {
+                U raw = static_cast<U>(v);
+                if constexpr (E == std::endian::big) raw = byteswap(static_cast<U>(raw << pad));
+                if (std::is_constant_evaluated())
+                    for (std::size_t i = 0; i < N / 8; ++i) bytes[i] = static_cast<byte>(raw >> (8 * i));
+                else
+                {
+                    std::size_t i = 0;
+                    store_piece<std::uint64_t>(raw, i);
+                    store_piece<std::uint32_t>(raw, i);
+                    store_piece<std::uint16_t>(raw, i);
+                    store_piece<std::uint8_t>(raw, i);
+                }
+            }
+        };
     }
 
     template<std::size_t N> using specific_int = detail::specific_int<signed, N>;
     template<std::size_t N> using specific_uint = detail::specific_int<unsigned, N>;
 
+    template<std::size_t N> using be_int = detail::endian_int<signed, N, std::endian::big>;
+    template<std::size_t N> using be_uint = detail::endian_int<unsigned, N, std::endian::big>;
+    template<std::size_t N> using le_int = detail::endian_int<signed, N, std::endian::little>;
+    template<std::size_t N> using le_uint = detail::endian_int<unsigned, N, std::endian::little>;
+
     static_assert( sizeof(specific_uint<48>) == 6);
     static_assert( sizeof(specific_uint<24>) == 3);
     static_assert( sizeof(specific_uint<12>) == 2);
@@ -40,6 +129,9 @@ namespace jw
     static_assert(alignof(specific_uint<24>) == 1);
     static_assert(alignof(specific_uint<12>) == 1);
     static_assert(alignof(specific_uint< 6>) == 1);
+    static_assert( sizeof(be_uint<24>) == 3);
+    static_assert( sizeof(le_int<48>) == 6);
+    static_assert(alignof(be_uint<64>) == 1);
 }
 
 #pragma GCC diagnostic pop
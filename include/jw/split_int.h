@@ -4,6 +4,7 @@
 
 #pragma once
 #include <cstdint>
+#include <atomic>
 #include <jw/common.h>
 
 #pragma GCC diagnostic push
@@ -61,6 +62,87 @@ namespace jw
             constexpr split_int(std::integral auto v) noexcept : value { static_cast<decltype(value)>(v) } { };
             constexpr operator auto() const noexcept { return value; }
         };
+
+        // Atomic split_int, for counters that are read from other threads
+        // or interrupt handlers.  Full loads and read-modify-write use a
+        // single 64-bit access (CMPXCHG8B on i586+), so values never tear.
+        // Only available where these are lock-free, which makes it safe,
+        // unlike a seqlock, to read from an interrupt that preempts the
+        // writer.  The low half alone can be read with a plain 32-bit load.
+        template<typename T, std::size_t size>
+        struct atomic_split_int
+        {
+            static_assert(size == 32 or size == 64);
+            using value_type = split_int<T, size>;
+            using int_type = std::conditional_t<size == 64,
+                std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>,
+                std::conditional_t<std::is_signed_v<T>, std::int32_t, std::uint32_t>>;
+            using half_type = std::conditional_t<size == 64, std::uint32_t, std::uint16_t>;
+
+            static constexpr bool is_always_lock_free = std::atomic_ref<int_type>::is_always_lock_free;
+            static_assert(is_always_lock_free, "atomic_split_int requires lock-free 64-bit atomics (i586 or later)");
+
+            constexpr atomic_split_int() noexcept : value { 0 } { }
+            constexpr atomic_split_int(value_type v) noexcept : value { static_cast<int_type>(v) } { }
+            atomic_split_int(const atomic_split_int&) = delete;
+            atomic_split_int& operator=(const atomic_split_int&) = delete;
+
+            value_type load(std::memory_order o = std::memory_order_seq_cst) const noexcept { return { full().load(o) }; }
+            void store(value_type v, std::memory_order o = std::memory_order_seq_cst) noexcept { full().store(static_cast<int_type>(v), o); }
+            value_type exchange(value_type v, std::memory_order o = std::memory_order_seq_cst) noexcept { return { full().exchange(static_cast<int_type>(v), o) }; }
+
+            bool compare_exchange_weak(value_type& expected, value_type desired, std::memory_order o = std::memory_order_seq_cst) noexcept
+            {
+                int_type e = expected;
+                const bool ok = full().compare_exchange_weak(e, static_cast<int_type>(desired), o);
+                expected = e;
+                return ok;
+            }
+
+            bool compare_exchange_strong(value_type& expected, value_type desired, std::memory_order o = std::memory_order_seq_cst) noexcept
+            {
+                int_type e = expected;
+                const bool ok = full().compare_exchange_strong(e, static_cast<int_type>(desired), o);
+                expected = e;
+                return ok;
+            }
+
+            value_type fetch_add(int_type v, std::memory_order o = std::memory_order_seq_cst) noexcept { return { full().fetch_add(v, o) }; }
+            value_type fetch_sub(int_type v, std::memory_order o = std::memory_order_seq_cst) noexcept { return { full().fetch_sub(v, o) }; }
+
+            // Read one half only.  This is a single narrow access, and much
+            // cheaper than a full snapshot on 32-bit targets.  Useful for
+            // short intervals, where wrap-around of the low half is handled
+            // by unsigned subtraction.
+            half_type load_lo(std::memory_order o = std::memory_order_seq_cst) const noexcept { return std::atomic_ref<half_type> { const_cast<half_type&>(half.lo) }.load(o); }
+            half_type load_hi(std::memory_order o = std::memory_order_seq_cst) const noexcept { return std::atomic_ref<half_type> { const_cast<half_type&>(half.hi) }.load(o); }
+
+            operator value_type() const noexcept { return load(); }
+            value_type operator=(value_type v) noexcept { store(v); return v; }
+            value_type operator+=(int_type v) noexcept { return { static_cast<unsigned_type>(full().fetch_add(v)) + v }; }
+            value_type operator-=(int_type v) noexcept { return { static_cast<unsigned_type>(full().fetch_sub(v)) - v }; }
+            value_type operator++() noexcept { return *this += 1; }
+            value_type operator--() noexcept { return *this -= 1; }
+            value_type operator++(int) noexcept { return fetch_add(1); }
+            value_type operator--(int) noexcept { return fetch_sub(1); }
+
+        private:
+            using unsigned_type = std::make_unsigned_t<int_type>;
+
+            auto full() noexcept { return std::atomic_ref<int_type> { value }; }
+            // std::atomic_ref<const T> is not available before C++26.
+            auto full() const noexcept { return std::atomic_ref<int_type> { const_cast<int_type&>(value) }; }
+
+            union alignas(std::atomic_ref<int_type>::required_alignment)
+            {
+                int_type value;
+                struct
+                {
+                    half_type lo;
+                    half_type hi;
+                } half;
+            };
+        };
     }
 
     template<std::size_t N> using split_uint = detail::split_int<unsigned, N>;
@@ -73,12 +155,22 @@ namespace jw
     using split_int32_t = split_int<32>;
     using split_int64_t = split_int<64>;
 
+    template<std::size_t N> using atomic_split_uint = detail::atomic_split_int<unsigned, N>;
+    template<std::size_t N> using atomic_split_int = detail::atomic_split_int<signed, N>;
+
+    using atomic_split_uint32_t = atomic_split_uint<32>;
+    using atomic_split_uint64_t = atomic_split_uint<64>;
+    using atomic_split_int32_t = atomic_split_int<32>;
+    using atomic_split_int64_t = atomic_split_int<64>;
+
     static_assert(sizeof(split_uint64_t) == 8);
     static_assert(sizeof(split_uint32_t) == 4);
     static_assert(sizeof(split_uint16_t) == 2);
     static_assert(alignof(split_uint64_t) == 4);
     static_assert(alignof(split_uint32_t) == 4);
     static_assert(alignof(split_uint16_t) == 2);
+    static_assert(sizeof(atomic_split_uint64_t) == 8);
+    static_assert(alignof(atomic_split_uint64_t) == 8);
 }
 
 #pragma GCC diagnostic pop
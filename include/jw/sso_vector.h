@@ -755,7 +755,7 @@ namespace jw
         [[nodiscard]] constexpr pointer allocate(allocator_type& a, size_type cap)
         {
             assert(std::has_single_bit(cap));
-            assert(cap > min_alloc_size);
+            assert(cap >= min_alloc_size);
             return allocator_traits::allocate(a, cap);
         }
 
@@ -1020,6 +1020,18 @@ namespace jw
         a.swap(b);
     }
 
+    template <typename T, std::size_t N, typename A1, std::size_t M, typename A2>
+    constexpr bool operator==(const sso_vector<T, N, A1>& a, const sso_vector<T, M, A2>& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    template <typename T, std::size_t N, typename A1, std::size_t M, typename A2>
+    constexpr auto operator<=>(const sso_vector<T, N, A1>& a, const sso_vector<T, M, A2>& b)
+    {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
     template <typename T, std::size_t N, typename A, typename U>
     constexpr typename sso_vector<T, N, A>::size_type erase(sso_vector<T, N, A>& c, const U& value)
     {
@@ -3,6 +3,60 @@
 
 #pragma once
 #include <variant>
+#include <array>
+#include <functional>
+#include <utility>
+#include <jw/common.h>
+
+namespace jw::detail
+{
+    template<typename V>
+    inline constexpr std::size_t variant_size_of = std::variant_size_v<std::remove_cvref_t<V>>;
+
+    // Split a flat visitation table index into one index per variant.
+    template<std::size_t Flat, typename... V>
+    consteval std::array<std::size_t, sizeof...(V)> split_visit_index()
+    {
+        constexpr std::array<std::size_t, sizeof...(V)> sizes { variant_size_of<V>... };
+        std::array<std::size_t, sizeof...(V)> index { };
+        std::size_t i = Flat;
+        for (std::size_t n = sizeof...(V); n-- > 0;)
+        {
+            index[n] = i % sizes[n];
+            i /= sizes[n];
+        }
+        return index;
+    }
+
+    // Also finds get() for variant-like types through ADL.
+    template<std::size_t I, typename V>
+    constexpr decltype(auto) get_unchecked(V&& variant) noexcept
+    {
+        using std::get;
+        assume(variant.index() == I);
+        return get<I>(std::forward<V>(variant));
+    }
+
+    template<std::size_t Flat, typename F, typename... V>
+    constexpr decltype(auto) visit_entry(F&& visitor, V&&... variants)
+    {
+        constexpr auto index = split_visit_index<Flat, V...>();
+        return [&]<std::size_t... N>(std::index_sequence<N...>) -> decltype(auto)
+        {
+            return std::invoke(std::forward<F>(visitor), get_unchecked<index[N]>(std::forward<V>(variants))...);
+        }(std::index_sequence_for<V...> { });
+    }
+
+    template<typename F, typename... V, std::size_t... Flat>
+    consteval auto make_visit_table(std::index_sequence<Flat...>)
+    {
+        using R = decltype(visit_entry<0>(std::declval<F>(), std::declval<V>()...));
+        return std::array<R(*)(F&&, V&&...), sizeof...(Flat)> { visit_entry<Flat, F, V...>... };
+    }
+
+    template<typename F, typename... V>
+    inline constexpr auto visit_table = make_visit_table<F, V...>(std::make_index_sequence<(variant_size_of<V> * ...)> { });
+}
 
 namespace jw
 {
@@ -23,14 +77,16 @@ namespace jw
         else return variant_index<V, T, I + 1>();
     }
 
-    template<std::size_t I = 0, typename F, typename V>
-    constexpr decltype(auto) visit(F&& visitor, V&& variant)
+    // Invoke the visitor with the active alternatives of one or more
+    // variants.  Dispatch is done via a compile-time generated table of
+    // function pointers, so it takes constant time regardless of the number
+    // of alternatives.
+    template<typename F, typename... V> requires (sizeof...(V) > 0)
+    constexpr decltype(auto) visit(F&& visitor, V&&... variants)
     {
-        constexpr auto size = std::variant_size_v<std::remove_cvref_t<V>>;
-        if (auto* p = std::get_if<I>(&std::forward<V>(variant)))
-            return std::forward<F>(visitor)(*p);
-        else if constexpr (I + 1 < size)
-            return visit<I + 1>(std::forward<F>(visitor), std::forward<V>(variant));
-        throw std::bad_variant_access { };
+        if ((variants.valueless_by_exception() or ...)) throw std::bad_variant_access { };
+        std::size_t i = 0;
+        ((i = i * detail::variant_size_of<V> + variants.index()), ...);
+        return detail::visit_table<F, V...>[i](std::forward<F>(visitor), std::forward<V>(variants)...);
     }
 }